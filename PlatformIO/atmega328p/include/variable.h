@@ -13,7 +13,7 @@
 #define ECHO_PIN    4
 
 inline const uint16_t PINOUT_STEPPER[4] = {8, 10, 9, 11};
-inline const String ListTime[3]         = {"7:0:0", "12:0:0", "17:0:0"};
+inline const char* const ListTime[3]   = {"7:0:0", "12:0:0", "17:0:0"};
 
 #define DEGRESS_STEPPER 360
 #define SPEED_STEPPER   10
@@ -9,10 +9,11 @@ bool auto_state, switch_state;
 int capacity;
 
 void MyProgram::__autoFeeder__(void) {
+    char now[RTC_TIME_LEN];
     for (const auto listTime : ListTime) {
         if ((unsigned long) (millis() - this->LastTimeRTC) >= 1000) {
             this->LastTimeRTC = millis();
-            if (this->rtc.timestr() == listTime) {
+            if (strcmp(this->rtc.timestr(now), listTime) == 0) {
                 this->stateStepper1 = true;
                 this->LastTimeStepper1 = millis();
             }
@@ -60,11 +61,12 @@ void MyProgram::__monitor__(void) {
         Serial.println(F("%"));
 
         Serial.println();
+        char date[RTC_DATE_LEN], time[RTC_TIME_LEN];
         Serial.println(this->rtc.getDayOfWeek());
         Serial.print(F("Date : "));
-        Serial.println(this->rtc.datestr());
+        Serial.println(this->rtc.datestr(date));
         Serial.print(F("Time : "));
-        Serial.println(this->rtc.timestr());
+        Serial.println(this->rtc.timestr(time));
     }
 }
 
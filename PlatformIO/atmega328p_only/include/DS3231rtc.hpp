@@ -8,6 +8,11 @@
 #include <SPI.h>
 #include <RTClib.h>
 
+// Buffer sizes (including the terminator) for the formatting functions
+#define RTC_DATE_LEN        11  // "MM/DD/YYYY"
+#define RTC_TIME_LEN        9   // "HH:MM:SS"
+#define RTC_ISO8601_LEN     20  // "YYYY-MM-DDTHH:MM:SS"
+
 class DS3231rtc {
 public:
     void begin() {
@@ -55,18 +60,44 @@ public:
         if (second != nullptr) *second = this->DSnow().second();
     }
 
-    // function to get the date as a string
-    String datestr(void) {
-        return String(this->DSnow().month()) + "/" + String(this->DSnow().day()) + "/" + String(this->DSnow().year());
+    // function to write the date (M/D/YYYY) into buf, returns buf
+    template <size_t N> char* datestr(char (&buf)[N]) {
+        static_assert(N >= RTC_DATE_LEN, "date buffer too small");
+        this->__now__ = this->DSnow();
+        char* p = buf;
+        p = __digits__(p, this->__now__.month(), 1);  *p++ = '/';
+        p = __digits__(p, this->__now__.day(), 1);    *p++ = '/';
+        p = __digits__(p, this->__now__.year(), 4);   *p = '\0';
+        return buf;
+    }
+
+    // function to write the time (H:M:S) into buf, returns buf
+    template <size_t N> char* timestr(char (&buf)[N]) {
+        static_assert(N >= RTC_TIME_LEN, "time buffer too small");
+        this->__now__ = this->DSnow();
+        char* p = buf;
+        p = __digits__(p, this->__now__.hour(), 1);   *p++ = ':';
+        p = __digits__(p, this->__now__.minute(), 1); *p++ = ':';
+        p = __digits__(p, this->__now__.second(), 1); *p = '\0';
+        return buf;
     }
 
-    // function to get the time as string
-    String timestr(void) {
-        return String(this->DSnow().hour()) + ":" + String(this->DSnow().minute()) + ":" + String(this->DSnow().second());
+    // function to write the zero-padded ISO 8601 date and time into buf, returns buf
+    template <size_t N> char* iso8601(char (&buf)[N]) {
+        static_assert(N >= RTC_ISO8601_LEN, "ISO 8601 buffer too small");
+        this->__now__ = this->DSnow();
+        char* p = buf;
+        p = __digits__(p, this->__now__.year(), 4);   *p++ = '-';
+        p = __digits__(p, this->__now__.month(), 2);  *p++ = '-';
+        p = __digits__(p, this->__now__.day(), 2);    *p++ = 'T';
+        p = __digits__(p, this->__now__.hour(), 2);   *p++ = ':';
+        p = __digits__(p, this->__now__.minute(), 2); *p++ = ':';
+        p = __digits__(p, this->__now__.second(), 2); *p = '\0';
+        return buf;
     }
 
     // function to get day of week
-    String getDayOfWeek(void) {
+    const char* getDayOfWeek(void) {
         return this->listDayOfWeek[this->DSnow().dayOfTheWeek()];
     }
 
@@ -77,6 +108,19 @@ private:
         "Saturday"
     };
 
+    // write value in decimal, left-padded with zeros to width digits (max 5)
+    static char* __digits__(char* p, uint16_t value, uint8_t width) {
+        char tmp[5];
+        uint8_t n = 0;
+        do {
+            tmp[n++] = '0' + value % 10;
+            value /= 10;
+        } while (value != 0 && n < sizeof(tmp));
+        while (n < width && n < sizeof(tmp)) tmp[n++] = '0';
+        while (n != 0) *p++ = tmp[--n];
+        return p;
+    }
+
 private:
     RTC_DS3231 __rtc__;
     DateTime __now__;
@@ -20,4 +20,4 @@
 #define SPEED_STEPPER   10
 
 inline const uint16_t PINOUT_STEPPER[4] = {8, 10, 9, 11};
-inline const String List_Time[3]        = {"7:0:0", "12:0:0", "17:0:0"};
+inline const char* const List_Time[3]  = {"7:0:0", "12:0:0", "17:0:0"};
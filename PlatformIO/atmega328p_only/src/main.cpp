@@ -61,11 +61,12 @@ void __monitor_data__(void) {
         Serial.println(F("%"));
         Serial.println();
 
+        char date[RTC_DATE_LEN], time[RTC_TIME_LEN];
         Serial.println(rtc.getDayOfWeek());
         Serial.print(F("Date : "));
-        Serial.println(rtc.datestr());
+        Serial.println(rtc.datestr(date));
         Serial.print(F("Time : "));
-        Serial.println(rtc.timestr());
+        Serial.println(rtc.timestr(time));
     }
 }
 
@@ -87,8 +88,10 @@ void loop() {
     __monitor_data__();
 
     if (capacity >= 0) {
+        char now[RTC_TIME_LEN];
+        rtc.timestr(now);
         for (const auto listTime : List_Time) {
-            if (rtc.timestr() == listTime) {
+            if (strcmp(now, listTime) == 0) {
                 stateStepper = true;
                 LastTimeStepper = millis();
             }
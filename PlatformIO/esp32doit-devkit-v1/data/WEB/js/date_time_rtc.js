@@ -1,49 +1,24 @@
 class DateTimeRTC {
     constructor() {
-        this.XHR = new XMLHttpRequest();
         this.ws = null;
     }
 
-    static update(timeout) {
-        const __dataServer = new DateTimeRTC();
-        let xhr = __dataServer.XHR;
-
-        try {
-            xhr.abort();
-            xhr.open("GET", "/datetime", true);
-            xhr.onreadystatechange = () => {
-                if (xhr.readyState === 4) {
-                    if (xhr.status === 200) {
-                        let response = JSON.parse(xhr.responseText);
-                        let datetimertc = response.datetime;
-                        
-                        // Update DOM elements only if they exist
-                        const updateElement = (id, value) => {
-                            const elem = document.getElementById(id);
-                            if (elem) elem.innerHTML = value || "N/A";
-                        };
-
-                        updateElement("server-date", datetimertc?.date);
-                        updateElement("server-time", datetimertc?.time);
-                        
-                    } else {
-                        console.error("Error fetching data:", xhr.statusText);
-                    }
-                }
-            };
-            xhr.send();
-        } catch (error) {
-            console.error("XHR error:", error);
-        }
+    static render(datetime) {
+        // Update DOM elements only if they exist
+        const updateElement = (id, value) => {
+            const elem = document.getElementById(id);
+            if (elem) elem.innerHTML = value || "N/A";
+        };
 
-        // Safe timeout to prevent overlapping
-        setTimeout(() => DateTimeRTC.update(timeout), timeout);
+        updateElement("server-date", datetime?.date);
+        updateElement("server-time", datetime?.time);
     }
 
-    static listen() {
+    static listen(interval = 1000) {
         this.ws = new WebSocket(`ws://${window.location.host}/ws`);
         this.ws.onopen = () => {
-            this.ws.send(JSON.stringify({ event: "datetime" }));
+            // Subscribe once, the server pushes every `interval` ms
+            this.ws.send(JSON.stringify({ event: "subscribe", topics: ["datetime"], interval: interval }));
         };
         this.ws.onmessage = (event) => {
             const data = JSON.parse(event.data);
@@ -53,21 +28,13 @@ class DateTimeRTC {
             }
 
             if (data.event === "datetime") {
-                let datetime = data.datetime;
-                
-                const updateElement = (id, value) => {
-                    const elem = document.getElementById(id);
-                    if (elem) elem.innerHTML = value || "N/A";
-                };
-
-                updateElement("server-date", datetime?.date);
-                updateElement("server-time", datetime?.time);
+                DateTimeRTC.render(data.datetime);
             }
         };
 
         this.ws.onclose = () => {
             console.warn("WebSocket closed, reconneting...");
-            setTimeout(() => DateTimeRTC.listen(), 3000);
+            setTimeout(() => DateTimeRTC.listen(interval), 3000);
         };
         this.ws.onerror = (error) => {
             console.error("WebSocket error : ", error);
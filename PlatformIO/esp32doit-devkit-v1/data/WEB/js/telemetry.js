@@ -0,0 +1,44 @@
+// Decoder for the binary telemetry frame (include/MicroBox/TelemetryFrame.hpp).
+// Standalone client: no bundled page loads it. Dashboards and tools include it
+// with <script src="/js/telemetry.js"></script>; the bundled pages keep JSON.
+// Request it with:
+//   WebSocket: { event: "subscribe", topics: [...], format: "binary" } and ws.binaryType = "arraybuffer"
+//   HTTP:      GET /data-server with "Accept: application/vnd.microbox.telemetry"
+class Telemetry {
+    static VERSION = 1;
+    static SIZE = 32;
+    static MIME = "application/vnd.microbox.telemetry";
+    static TOPICS = ["data_server", "datetime"];
+
+    // Returns the decoded frame, or null if the buffer is not a frame of this version
+    static decode(buffer) {
+        if (!(buffer instanceof ArrayBuffer) || buffer.byteLength < Telemetry.SIZE) return null;
+
+        const view = new DataView(buffer);
+        if (view.getUint8(0) !== 0x4d || view.getUint8(1) !== 0x42) return null; // "MB"
+        if (view.getUint8(2) !== Telemetry.VERSION) return null;
+
+        const topic = view.getUint8(3);
+        return {
+            event: Telemetry.TOPICS[topic] ?? "http",
+            sequence: view.getUint32(4, true),
+            timestamp: view.getUint32(8, true),
+            unixtime: view.getUint32(12, true),
+            heap_memory: {
+                total_heap: view.getUint16(16, true) / 100,
+                free_heap: view.getUint16(18, true) / 100,
+            },
+            sensor: {
+                ph: view.getUint16(20, true) / 1000,
+                ntu: view.getInt32(22, true) / 100,
+                capacity: view.getInt16(26, true) / 100,
+                distance: view.getUint16(28, true) / 10,
+            },
+        };
+    }
+
+    static async fetch() {
+        const res = await fetch("/data-server", { headers: { Accept: Telemetry.MIME } });
+        return Telemetry.decode(await res.arrayBuffer());
+    }
+}
@@ -0,0 +1,86 @@
+import os, gzip, hashlib
+from SCons.Script import DefaultEnvironment
+
+# Optional: compile data/WEB into the firmware as byte arrays so the web
+# server never touches LittleFS. Enabled by -DWEB_ASSETS_IN_FLASH in
+# build_flags; without it this script does nothing.
+#
+# css/js are stored gzipped; html stays plain because the template
+# processor has to scan it for %TOKEN% placeholders.
+#
+# Output: $BUILD_DIR/generated/WebAssets.h (not checked in)
+
+compress_ext = (".css", ".js")
+mime_types = {
+    ".html": "text/html",
+    ".css":  "text/css",
+    ".js":   "application/javascript",
+}
+
+class EmbedAssets:
+    def __init__(self, src: str, header: str) -> None:
+        self.src = src
+        self.header = header
+        self.size_flash = 0
+
+    def __etag__(self, content: bytes) -> str:
+        return '\\"' + hashlib.sha1(content).hexdigest()[:16] + '\\"'
+
+    def __array__(self, name: str, content: bytes) -> str:
+        lines = []
+        for i in range(0, len(content), 16):
+            lines.append("    " + ", ".join(f"0x{b:02x}" for b in content[i:i + 16]) + ",")
+        body = "\n".join(lines)
+        return f"alignas(4) constexpr uint8_t {name}[] PROGMEM = {{\n{body}\n}};\n"
+
+    def process(self):
+        arrays, entries = [], []
+        web_dir = os.path.join(self.src, "WEB")
+
+        for root, _, files in os.walk(web_dir):
+            for name in sorted(files):
+                ext = os.path.splitext(name)[1]
+                if ext not in mime_types:
+                    continue
+
+                src_file = os.path.join(root, name)
+                with open(src_file, "rb") as f:
+                    content = f.read()
+
+                path = "/" + os.path.relpath(src_file, self.src).replace(os.sep, "/")
+                packed = gzip.compress(content, compresslevel=9, mtime=0) if ext in compress_ext else content
+                symbol = "asset_" + "".join(c if c.isalnum() else "_" for c in path.strip("/"))
+
+                arrays.append(self.__array__(symbol, packed))
+                entries.append(
+                    f'    {{ "{path}", "{mime_types[ext]}", "{self.__etag__(content)}", '
+                    f'{symbol}, sizeof({symbol}), {"true" if ext in compress_ext else "false"} }},'
+                )
+                self.size_flash += len(packed)
+
+        os.makedirs(os.path.dirname(self.header), exist_ok=True)
+        with open(self.header, "w") as f:
+            f.write("// Generated by embed_assets.py from data/WEB, do not edit\n\n")
+            f.write("#pragma once\n\n#include <Arduino.h>\n\n")
+            f.write("struct FlashAsset {\n")
+            f.write("    const char *path;       // LittleFS-style path, e.g. \"/WEB/js/clock.js\"\n")
+            f.write("    const char *mime;\n")
+            f.write("    const char *etag;       // quoted content hash of the original file\n")
+            f.write("    const uint8_t *data;\n")
+            f.write("    size_t length;\n")
+            f.write("    bool gzip;              // data is gzip compressed\n")
+            f.write("};\n\n")
+            f.write("\n".join(arrays))
+            f.write("\nconstexpr FlashAsset FlashAssets[] = {\n")
+            f.write("\n".join(entries))
+            f.write("\n};\n\n")
+            f.write("constexpr size_t FlashAssetCount = sizeof(FlashAssets) / sizeof(FlashAssets[0]);\n")
+
+        print(f"embed {len(entries)} web assets: {self.size_flash} bytes of flash")
+
+env = DefaultEnvironment()
+
+if "WEB_ASSETS_IN_FLASH" in env.subst("$BUILD_FLAGS"):
+    gen_dir = os.path.join(env.subst("$BUILD_DIR"), "generated")
+    EmbedAssets(env.subst("$PROJECT_DATA_DIR"), os.path.join(gen_dir, "WebAssets.h")).process()
+    env.Append(CPPPATH=[gen_dir])
@@ -0,0 +1,68 @@
+import os, gzip, hashlib, shutil
+from SCons.Script import DefaultEnvironment
+
+# Stage the LittleFS image from a copy of data/ where the static assets
+# (css, js) are replaced by their .gz variant. The web server serves the
+# .gz file with "Content-Encoding: gzip" and the content hash as ETag.
+#
+# data/                 -> source, left untouched
+# .pio/data_gz/<env>/   -> staged copy, used by buildfs / uploadfs
+
+compress_ext  = (".css", ".js")              # served as static assets
+manifest_name = os.path.join("WEB", "assets.etag")
+
+class GzipAssets:
+    def __init__(self, src: str, dest: str) -> None:
+        self.src = src
+        self.dest = dest
+        self.manifest = []
+        self.size_before = 0
+        self.size_after = 0
+
+    def __etag__(self, content: bytes) -> str:
+        return '"' + hashlib.sha1(content).hexdigest()[:16] + '"'
+
+    def __stage_file__(self, rel: str):
+        src_file = os.path.join(self.src, rel)
+        with open(src_file, "rb") as f:
+            content = f.read()
+
+        if not rel.endswith(compress_ext):
+            dest_file = os.path.join(self.dest, rel)
+            shutil.copyfile(src_file, dest_file)
+            return
+
+        # mtime=0 keeps the output (and the image) reproducible
+        packed = gzip.compress(content, compresslevel=9, mtime=0)
+        with open(os.path.join(self.dest, rel + ".gz"), "wb") as f:
+            f.write(packed)
+
+        self.manifest.append(("/" + rel.replace(os.sep, "/"), self.__etag__(content)))
+        self.size_before += len(content)
+        self.size_after += len(packed)
+        print(f"gzip {rel}: {len(content)} -> {len(packed)} bytes")
+
+    def process(self):
+        if os.path.exists(self.dest):
+            shutil.rmtree(self.dest)
+
+        for root, _, files in os.walk(self.src):
+            rel_root = os.path.relpath(root, self.src)
+            os.makedirs(os.path.join(self.dest, rel_root), exist_ok=True)
+            for name in sorted(files):
+                self.__stage_file__(os.path.normpath(os.path.join(rel_root, name)))
+
+        # One "<path> <etag>" line per compressed asset
+        with open(os.path.join(self.dest, manifest_name), "w") as f:
+            for path, etag in self.manifest:
+                f.write(f"{path} {etag}\n")
+
+        print(f"gzip total: {self.size_before} -> {self.size_after} bytes")
+
+env = DefaultEnvironment()
+data_dir = env.subst("$PROJECT_DATA_DIR")
+staged_dir = os.path.join(env.subst("$PROJECT_DIR"), ".pio", "data_gz", env.subst("$PIOENV"))
+
+if os.path.isdir(data_dir):
+    GzipAssets(data_dir, staged_dir).process()
+    env.Replace(PROJECT_DATA_DIR=staged_dir)
@@ -0,0 +1,97 @@
+/**
+ *  @file ADCSampler.h
+ *  @version 1.0.0
+ *  @brief Continuous (DMA) ADC sampling engine for the analog sensors.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include "config.h"
+
+/**
+ * @class ADCSamplerClass
+ * @brief Scans the analog sensor pins with the ESP32 ADC continuous (DMA) mode.
+ * 
+ * The ADC digital controller converts the configured ADC1 pins back to back
+ * and DMA moves the results into a driver buffer. A drain task decimates every
+ * `ADC_OVERSAMPLE` raw conversions of a pin into one value and keeps the last
+ * `ADC_RING_SIZE` decimated values in a ring buffer. `read()` only copies the
+ * published moving average, it never starts a conversion.
+ */
+class ADCSamplerClass {
+    public:
+        /**
+         * @brief Start continuous sampling of the given ADC1 pins.
+         * @param pins Array of analog pins (ADC1 only).
+         * @param count Number of pins, at most `ADC_SAMPLER_MAX_PINS`.
+         * @param sample_freq Total conversion rate in Hz, shared by all pins.
+         * @return `true` if the ADC driver and drain task were started.
+         */
+        bool begin(const uint8_t *pins, uint8_t count, uint32_t sample_freq = ADC_SAMPLE_FREQ_HZ);
+
+        /**
+         * @brief Check whether continuous sampling is active.
+         * @return `true` after a successful `begin()`.
+         */
+        bool running() const { return this->__running__; }
+
+        /**
+         * @brief Copy the latest oversampled value of a pin.
+         * @param pin The analog pin passed to `begin()`.
+         * @param value Receives the averaged 12-bit ADC value.
+         * @return `false` if the pin is not sampled or no value is ready yet.
+         */
+        bool read(uint8_t pin, uint16_t &value) const;
+
+        /**
+         * @brief Number of DMA buffer overflows (samples lost) since `begin()`.
+         */
+        uint32_t overruns() const { return this->__overruns__; }
+
+    private:
+        struct Channel {
+            uint8_t pin;                     ///< Arduino pin number
+            uint8_t channel;                 ///< ADC1 channel number
+            uint32_t accumulator;            ///< Sum of raw samples in the current block
+            uint16_t count;                  ///< Raw samples in the current block
+            uint16_t ring[ADC_RING_SIZE];    ///< Decimated values
+            uint8_t head;                    ///< Next ring slot to overwrite
+            uint8_t filled;                  ///< Valid entries in the ring
+            uint32_t ringSum;                ///< Sum of the valid ring entries
+            volatile uint16_t value;         ///< Published moving average
+            volatile bool ready;             ///< `value` holds at least one block
+        };
+
+        static void __task__(void *pvParameter);
+        void __drain__();
+        void __push__(Channel &ch, uint16_t raw);
+
+        Channel __channels__[ADC_SAMPLER_MAX_PINS];
+        uint8_t __count__ = 0;
+        bool __running__ = false;
+        volatile uint32_t __overruns__ = 0;
+};
+
+#if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_ADCSampler)
+extern ADCSamplerClass ADCSampler;
+#endif
@@ -0,0 +1,107 @@
+/**
+ *  @file AsyncWebExchange.h
+ *  @version 1.0.0
+ *  @brief WebExchange on top of an ESPAsyncWebServer request.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "PooledExchange.h"
+
+/**
+ * @class AsyncWebExchange
+ * @brief WebExchange on top of an ESPAsyncWebServer request.
+ * 
+ * Pooled bodies are sent with beginResponse_P(), which reads the slot in
+ * place, and released in the request's onDisconnect() callback.
+ */
+class AsyncWebExchange : public PooledExchange {
+    public:
+        explicit AsyncWebExchange(AsyncWebServerRequest *req) : __req__(req) {}
+
+        const char *url() const override { return this->__req__->url().c_str(); }
+        bool isGet() const override { return this->__req__->method() == HTTP_GET; }
+
+        const char *localIP() const override {
+            if (this->__localIP__[0] == '\0') {
+                snprintf(this->__localIP__, sizeof(this->__localIP__), "%s",
+                    this->__req__->client()->localIP().toString().c_str());
+            }
+            return this->__localIP__;
+        }
+
+        size_t args() const override { return this->__req__->args(); }
+        const char *argName(size_t i) const override { return this->__req__->argName(i).c_str(); }
+        const char *arg(size_t i) const override { return this->__req__->arg(i).c_str(); }
+
+        const char *arg(const char *name) const override {
+            for (size_t i = 0; i < this->__req__->args(); i++) {
+                if (this->__req__->argName(i) == name) return this->__req__->arg(i).c_str();
+            }
+            return nullptr;
+        }
+
+        const char *header(const char *name) const override {
+            AsyncWebHeader *h = this->__req__->getHeader(name);
+            return h != nullptr ? h->value().c_str() : nullptr;
+        }
+
+        void sendChunked(int code, const char *mime, Filler filler) override {
+            AsyncWebServerResponse *res = this->__req__->beginChunkedResponse(mime,
+                [filler](uint8_t *buf, size_t maxLen, size_t index) { return filler(buf, maxLen); }
+            );
+            res->setCode(code);
+            this->__req__->send(res);
+        }
+
+    protected:
+        void __sendSlot__(int code, const char *mime, char *slot, size_t len) override {
+            // The body is read while the response is sent; give the slot back once the connection is gone
+            this->__req__->onDisconnect([slot]() { ResponsePool::release(slot); });
+            this->__req__->send(this->__req__->beginResponse_P(code, mime, (const uint8_t *)slot, len));
+        }
+
+        JsonSink &__beginStream__(int code, const char *mime, size_t len) override {
+            AsyncResponseStream *res = this->__req__->beginResponseStream(mime, len);
+            res->setCode(code);
+            this->__streamSink__.res = res;
+            return this->__streamSink__;
+        }
+
+        void __endStream__() override {
+            this->__req__->send(this->__streamSink__.res);
+        }
+
+    private:
+        // JsonSink over the fallback stream response
+        struct StreamSink : public JsonSink {
+            using JsonSink::write;
+            size_t write(const uint8_t *data, size_t len) override { return this->res->write(data, len); }
+            AsyncResponseStream *res = nullptr;
+        };
+
+        AsyncWebServerRequest *__req__;  ///< The wrapped request
+        mutable char __localIP__[40] = {}; ///< localIP(), filled on first use
+        StreamSink __streamSink__;       ///< Writes into the fallback stream
+};
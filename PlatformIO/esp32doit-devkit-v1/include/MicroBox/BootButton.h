@@ -25,7 +25,9 @@
 
 #include <Arduino.h>
 #include <pushbutton.h>
-#include "MyEEPROM.hpp"
+#include "ConfigStore.hpp"
+#include "RetainedLog.h"
+#include "Logger.h"
 
 class BootButton {
     public:
@@ -33,7 +35,7 @@ class BootButton {
 
         void begin() {
             this->__bootButton__.init();
-            this->__wifiState__ = this->__myEEPROM__.read(ADDR_EEPROM_WIFI_MODE);
+            this->__wifiState__ = ConfigStore::wifiMode();
         }
 
         void ChageWiFiMode() {
@@ -44,12 +46,11 @@ class BootButton {
             if (this->__buttonChange__) {
                 if (this->__currentButtonState__ == false) {
                     this->__wifiState__ = !this->__wifiState__;
-                    this->__myEEPROM__.save_wifi_state(this->__wifiState__);
-                    delay(50);
-                    Serial.print(F("WiFi Mode : "));
-                    Serial.println(this->__wifiState__ ? F("MODE STA") : F("MODE AP"));
+                    ConfigStore::setWifiMode(this->__wifiState__);
+                    ConfigStore::flush();
+                    LOG_INFO("button", "WiFi Mode : %s", this->__wifiState__ ? "MODE STA" : "MODE AP");
                     delay(2000);
-                    ESP.restart();
+                    RetainedLog::restart(REBOOT_BUTTON);
                 }
                 this->__buttonChange__ = false;
             }
@@ -58,7 +59,6 @@ class BootButton {
 
     private:
         PushButtonDigital __bootButton__;
-        MyEEPROM __myEEPROM__;
         bool __currentButtonState__ = false;
         bool __lastButtonState__    = false;
         bool __buttonChange__       = false;
@@ -0,0 +1,314 @@
+/**
+ *  @file ConfigStore.hpp
+ *  @version 1.0.0
+ *  @brief RAM copy of the persistent settings with write-behind EEPROM persistence.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <Arduino.h>
+#include <rom/crc.h>
+#include "MyEEPROM.hpp"
+#include "config.h"
+#include "Logger.h"
+
+/**
+ * @brief Persistent settings, kept in RAM after boot.
+ * 
+ * This is the payload of the stored blob. Only append fields at the end
+ * and bump CONFIG_VERSION: an older blob is loaded over the defaults, so
+ * new fields keep their default, and an older firmware keeps the bytes it
+ * does not know and writes them back unchanged.
+ */
+struct __attribute__((packed)) SysConfig {
+    bool wifiMode;      ///< `true` = STA (Blynk), `false` = AP (web server)
+    bool autoControl;   ///< `true` = scheduled feeding, `false` = manual
+};
+
+/**
+ * @class ConfigStore
+ * @brief Loads the settings from EEPROM once and serves them from RAM.
+ * 
+ * Setters only touch the RAM copy and mark it dirty; unchanged values are
+ * ignored. run() writes the dirty copy back once no change has arrived for
+ * CONFIG_FLUSH_DELAY_MS, so a burst of updates costs one EEPROM.commit().
+ * Call flush() before a restart so pending changes are not lost.
+ * 
+ * The settings are stored as one blob (header + SysConfig) with a CRC32,
+ * written alternately to two slots with an increasing sequence number. A
+ * commit never touches the slot holding the current settings, so an
+ * interrupted or corrupted write leaves the previous copy to load from.
+ * Boot reads both slots from the EEPROM buffer and keeps the newest valid
+ * one; with no valid slot the old fixed-address bytes are migrated once.
+ * 
+ * On the ESP32 the EEPROM library stores its whole buffer as one NVS blob,
+ * so every commit rewrites CONFIG_EEPROM_SIZE bytes. The erase counter is an
+ * estimate from the number of NVS entries a commit consumes per 4 KB page.
+ */
+class ConfigStore {
+    public:
+        /**
+         * @brief Read the EEPROM and load the newest valid settings blob.
+         */
+        static void begin() {
+            instance().__begin__();
+        }
+
+        /**
+         * @brief Get the Wi-Fi mode setting.
+         * @return `true` for STA mode, `false` for AP mode.
+         */
+        static bool wifiMode() {
+            return instance().__config__().wifiMode;
+        }
+
+        /**
+         * @brief Get the auto control setting.
+         * @return `true` if scheduled feeding is enabled.
+         */
+        static bool autoControl() {
+            return instance().__config__().autoControl;
+        }
+
+        /**
+         * @brief Change the Wi-Fi mode setting (persisted write-behind).
+         * @param state `true` for STA mode, `false` for AP mode.
+         */
+        static void setWifiMode(bool state) {
+            instance().__set__(instance().__config__().wifiMode, state);
+        }
+
+        /**
+         * @brief Change the auto control setting (persisted write-behind).
+         * @param state `true` to enable scheduled feeding.
+         */
+        static void setAutoControl(bool state) {
+            instance().__set__(instance().__config__().autoControl, state);
+        }
+
+        /**
+         * @brief Persist pending changes once they have settled. Call periodically.
+         */
+        static void run() {
+            ConfigStore &self = instance();
+            if (self.__dirty__ && (unsigned long)(millis() - self.__lastChange__) >= CONFIG_FLUSH_DELAY_MS) {
+                self.__flush__();
+            }
+        }
+
+        /**
+         * @brief Persist pending changes now.
+         * @return `true` if nothing was pending or the commit succeeded.
+         */
+        static bool flush() {
+            return instance().__flush__();
+        }
+
+        /**
+         * @brief Number of EEPROM commits since boot.
+         */
+        static uint32_t commits() {
+            return instance().__commits__;
+        }
+
+        /**
+         * @brief Estimated flash sector erases caused by the commits since boot.
+         */
+        static uint32_t sectorErases() {
+            // NVS: 126 entries of 32 bytes per 4 KB page; one commit uses the
+            // blob data entries plus a chunk header and a blob index entry
+            const uint32_t entriesPerCommit = (CONFIG_EEPROM_SIZE + 31) / 32 + 2;
+            return instance().__commits__ * entriesPerCommit / 126;
+        }
+
+        static uint32_t loadMicros() { return instance().__loadMicros__; }          ///< EEPROM read and blob selection at boot (us)
+        static uint32_t commitMicros() { return instance().__commitMicros__; }      ///< Duration of the last commit (us)
+        static uint32_t worstCommitMicros() { return instance().__worstCommit__; }  ///< Slowest commit since boot (us)
+        static uint8_t activeSlot() { return instance().__active__; }               ///< Slot holding the current settings (0 or 1)
+        static uint32_t sequence() { return instance().__sequence__; }              ///< Sequence number of that slot
+
+    private:
+        static ConfigStore &instance() {
+            static ConfigStore instance;
+            return instance;
+        }
+
+    private:
+        /**
+         * @brief Header in front of the payload in each slot.
+         */
+        struct __attribute__((packed)) BlobHeader {
+            uint32_t magic;     ///< CONFIG_MAGIC
+            uint16_t version;   ///< CONFIG_VERSION of the firmware that wrote the payload
+            uint16_t length;    ///< Payload bytes, may differ from sizeof(SysConfig)
+            uint32_t sequence;  ///< Incremented on each commit, the newest slot wins
+            uint32_t crc;       ///< CRC32 of the payload, then of the header up to this field
+        };
+
+        struct __attribute__((packed)) Blob {
+            BlobHeader header;
+            uint8_t payload[CONFIG_SLOT_SIZE - sizeof(BlobHeader)];
+        };
+
+        static_assert(sizeof(SysConfig) <= CONFIG_SLOT_SIZE - sizeof(BlobHeader), "SysConfig does not fit CONFIG_SLOT_SIZE");
+        static_assert(CONFIG_SLOT_ADDR + 2 * CONFIG_SLOT_SIZE <= CONFIG_EEPROM_SIZE, "config slots exceed CONFIG_EEPROM_SIZE");
+
+        static uint32_t __crc__(const Blob &blob) {
+            uint32_t crc = crc32_le(0, blob.payload, blob.header.length);
+            return crc32_le(crc, (const uint8_t *)&blob.header, offsetof(BlobHeader, crc));
+        }
+
+        static bool __valid__(const Blob &blob) {
+            return blob.header.magic == CONFIG_MAGIC &&
+                   blob.header.length >= 1 && blob.header.length <= sizeof(blob.payload) &&
+                   blob.header.crc == __crc__(blob);
+        }
+
+        SysConfig &__config__() {
+            return *reinterpret_cast<SysConfig *>(this->__blob__.payload);
+        }
+
+        void __begin__() {
+            uint32_t start = micros();
+            this->eeprom.initialize(CONFIG_EEPROM_SIZE);
+
+            // Both slots come out of the RAM buffer EEPROM.begin() filled in one read
+            Blob slots[2];
+            EEPROM.get(CONFIG_SLOT_ADDR, slots[0]);
+            EEPROM.get(CONFIG_SLOT_ADDR + CONFIG_SLOT_SIZE, slots[1]);
+            bool valid[2] = { __valid__(slots[0]), __valid__(slots[1]) };
+
+            int8_t active = -1;
+            if (valid[0] && valid[1]) active = (int32_t)(slots[1].header.sequence - slots[0].header.sequence) > 0 ? 1 : 0;
+            else if (valid[0] || valid[1]) active = valid[1] ? 1 : 0;
+
+            // A magic without a valid CRC means the blob was there and got damaged
+            bool corrupt = active < 0 && (slots[0].header.magic == CONFIG_MAGIC || slots[1].header.magic == CONFIG_MAGIC);
+
+            SysConfig defaults = { false, false };
+            bool migrate = false;
+
+            portENTER_CRITICAL(&this->__mux__);
+            memset(&this->__blob__, 0, sizeof(this->__blob__));
+            memcpy(this->__blob__.payload, &defaults, sizeof(defaults));
+
+            if (active >= 0) {
+                // Older payloads are shorter and keep the defaults; newer ones keep their tail
+                const Blob &blob = slots[active];
+                memcpy(this->__blob__.payload, blob.payload, blob.header.length);
+                this->__blob__.header = blob.header;
+                this->__active__ = active;
+                this->__sequence__ = blob.header.sequence;
+            }
+            else if (corrupt) {
+                // The fixed addresses are stale once a blob was written, start from the defaults
+                this->__blob__.header.magic = CONFIG_MAGIC;
+                this->__active__ = 1;   // So the next commit goes to slot 0
+                this->__sequence__ = 0;
+            }
+            else {
+                // No blob yet: take the settings from the old fixed addresses once
+                this->__config__().wifiMode = this->eeprom.read(ADDR_EEPROM_WIFI_MODE) != 0;
+                this->__config__().autoControl = this->eeprom.read(ADDR_EEPROM_AUTO_CONTROL) != 0;
+                this->__blob__.header.magic = CONFIG_MAGIC;
+                this->__active__ = 1;   // So the first commit goes to slot 0
+                this->__sequence__ = 0;
+                migrate = true;
+            }
+            if (this->__blob__.header.length < sizeof(SysConfig)) this->__blob__.header.length = sizeof(SysConfig);
+            if (this->__blob__.header.version < CONFIG_VERSION) this->__blob__.header.version = CONFIG_VERSION;
+            this->__dirty__ = migrate;
+            portEXIT_CRITICAL(&this->__mux__);
+
+            this->__loadMicros__ = micros() - start;
+            if (migrate) {
+                LOG_INFO("config", "no valid blob, fixed-address settings migrated in %u us", this->__loadMicros__);
+            } else if (corrupt) {
+                LOG_ERROR("config", "both slots fail the CRC (seq %u / %u), defaults loaded",
+                    slots[0].header.sequence, slots[1].header.sequence);
+            } else {
+                LOG_INFO("config", "slot %u seq %u v%u loaded in %u us",
+                    this->__active__, this->__sequence__, this->__blob__.header.version, this->__loadMicros__);
+            }
+
+            if (migrate) this->__flush__();
+        }
+
+        void __set__(bool &field, bool state) {
+            portENTER_CRITICAL(&this->__mux__);
+            if (field != state) {
+                field = state;
+                this->__dirty__ = true;
+                this->__lastChange__ = millis();
+            }
+            portEXIT_CRITICAL(&this->__mux__);
+        }
+
+        bool __flush__() {
+            // Take a consistent copy, the commit itself runs outside the lock
+            portENTER_CRITICAL(&this->__mux__);
+            bool dirty = this->__dirty__;
+            Blob blob = this->__blob__;
+            this->__dirty__ = false;
+            portEXIT_CRITICAL(&this->__mux__);
+
+            if (!dirty) return true;
+
+            // Always the other slot, the current one stays intact until this commit is done
+            uint8_t slot = this->__active__ ^ 1;
+            blob.header.sequence = this->__sequence__ + 1;
+            blob.header.crc = __crc__(blob);
+
+            uint32_t start = micros();
+            EEPROM.put(CONFIG_SLOT_ADDR + slot * CONFIG_SLOT_SIZE, blob);
+            bool ok = EEPROM.commit();
+            this->__commitMicros__ = micros() - start;
+            if (this->__commitMicros__ > this->__worstCommit__) this->__worstCommit__ = this->__commitMicros__;
+            this->__commits__++;
+
+            if (ok) {
+                this->__active__ = slot;
+                this->__sequence__ = blob.header.sequence;
+            }
+            else {
+                // Keep the change pending and retry after the next delay
+                portENTER_CRITICAL(&this->__mux__);
+                this->__dirty__ = true;
+                this->__lastChange__ = millis();
+                portEXIT_CRITICAL(&this->__mux__);
+            }
+            return ok;
+        }
+
+    private:
+        MyEEPROM eeprom;                                        ///< EEPROM access for loading
+        Blob __blob__ = {};                                     ///< RAM copy of the stored blob, payload is the SysConfig
+        portMUX_TYPE __mux__ = portMUX_INITIALIZER_UNLOCKED;    ///< Guards the RAM copy
+        volatile bool __dirty__ = false;                        ///< RAM copy differs from EEPROM
+        unsigned long __lastChange__ = 0;                       ///< millis() of the last change
+        uint8_t __active__ = 1;                                 ///< Slot of the newest valid blob
+        uint32_t __sequence__ = 0;                              ///< Its sequence number
+        uint32_t __commits__ = 0;                               ///< EEPROM commits since boot
+        uint32_t __loadMicros__ = 0;                            ///< Boot load time (us)
+        uint32_t __commitMicros__ = 0;                          ///< Last commit time (us)
+        uint32_t __worstCommit__ = 0;                           ///< Slowest commit (us)
+};
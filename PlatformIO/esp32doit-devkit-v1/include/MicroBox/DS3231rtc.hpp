@@ -26,10 +26,19 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include <RTClib.h>
+#include "config.h"
+#include "Logger.h"
 
 /**
  * @class DS3231rtc
  * @brief A wrapperclass for managing the DS3231 RTC module using RTClib.
+ * 
+ * The time is read from the chip in one I2C transaction at most once per
+ * RTC_SYNC_INTERVAL_MS and advanced with millis() in between, so all the
+ * getters below are served from the cached clock. A re-read that agrees
+ * with the cached clock keeps its sub-second phase, one that is ahead moves
+ * the phase closer to the chip's second edge; the cached value may lag the
+ * chip by less than one second. Use sync() where an exact read matters.
  */
 class DS3231rtc : public RTC_DS3231 {
     public:
@@ -46,27 +55,72 @@ class DS3231rtc : public RTC_DS3231 {
          */
         void begin(bool twelve_hour_format_flag = false) {
             while (!RTC_DS3231::begin()) {
-                Serial.println(F("Status : Couldn't find RTC"));
+                LOG_ERROR("rtc", "Couldn't find RTC");
                 delay(100);
             }
 
             if (RTC_DS3231::lostPower()) {
-                Serial.println(F("Status : RTC Lost Power, setting the time!"));
-                RTC_DS3231::adjust(DateTime(F(__DATE__), F(__TIME__)));
+                LOG_WARN("rtc", "RTC lost power, setting the time!");
+                this->adjust(DateTime(F(__DATE__), F(__TIME__)));
             }
 
             this->twelve_hour_format_flag = twelve_hour_format_flag;
-            Serial.println();
-            Serial.println(F("DS3231rtc Initializing..."));
-            Serial.printf("Date : %s\nTime : %s\n\n\n", this->datestr().c_str(), this->timestr().c_str());
+            char date[RTC_DATE_LEN], time[RTC_TIME_LEN];
+            LOG_INFO("rtc", "DS3231rtc initialized, date %s, time %s", this->datestr(date), this->timestr(time));
         }
 
         /**
          * @brief Get the current date and time as a DateTime object.
+         * @details Served from the cached clock, reads the RTC only when the cache is stale.
          * @return `DateTime` The current date and time.
          */
         DateTime now() {
-            return RTC_DS3231::now();
+            uint32_t ms = millis();
+            uint32_t base, at;
+            bool synced;
+
+            portENTER_CRITICAL(&this->__mux__);
+            base = this->__syncTime__;
+            at = this->__syncMillis__;
+            synced = this->__synced__;
+            portEXIT_CRITICAL(&this->__mux__);
+
+            if (!synced || (uint32_t)(ms - at) >= RTC_SYNC_INTERVAL_MS) return this->sync();
+            return DateTime(base + (ms - at) / 1000);
+        }
+
+        /**
+         * @brief Read the RTC now (one I2C burst) and restart the cached clock from it.
+         * @return `DateTime` The time read from the chip.
+         */
+        DateTime sync() {
+            DateTime t = RTC_DS3231::now();
+            uint32_t ms = millis();
+
+            portENTER_CRITICAL(&this->__mux__);
+            uint32_t elapsed = ms - this->__syncMillis__;
+            if (this->__synced__ && this->__syncTime__ + elapsed / 1000 == t.unixtime()) {
+                // Same second as the cached clock: keep the millis phase of its second edge
+                this->__syncTime__ = t.unixtime();
+                this->__syncMillis__ = ms - elapsed % 1000;
+            } else {
+                this->__syncTime__ = t.unixtime();
+                this->__syncMillis__ = ms;
+            }
+            this->__synced__ = true;
+            portEXIT_CRITICAL(&this->__mux__);
+            return t;
+        }
+
+        /**
+         * @brief Set the RTC time and drop the cached clock.
+         * @param dt The new date and time.
+         */
+        void adjust(const DateTime &dt) {
+            RTC_DS3231::adjust(dt);
+            portENTER_CRITICAL(&this->__mux__);
+            this->__synced__ = false;
+            portEXIT_CRITICAL(&this->__mux__);
         }
 
         /**
@@ -83,14 +137,14 @@ class DS3231rtc : public RTC_DS3231 {
             uint8_t month, uint8_t day, uint16_t year,
             uint8_t hour, uint8_t minute, uint8_t second
         ) {
-            RTC_DS3231::adjust(DateTime(year, month, day, hour, minute, second));
+            this->adjust(DateTime(year, month, day, hour, minute, second));
         }
 
         /**
          * @brief Automatically adjust the RTC time to the compile date and time
          */
         void autoAdjust(void) {
-            RTC_DS3231::adjust(DateTime(F(__DATE__), F(__TIME__)));
+            this->adjust(DateTime(F(__DATE__), F(__TIME__)));
         }
 
         /**
@@ -103,9 +157,10 @@ class DS3231rtc : public RTC_DS3231 {
          */
         template <typename T>
         void date(T *month = nullptr, T *day = nullptr, T *year = nullptr) {
-            if (month != nullptr) *month = this->now().month();
-            if (day != nullptr)   *day   = this->now().day();
-            if (year != nullptr)  *year  = this->now().year();
+            DateTime t = this->now();
+            if (month != nullptr) *month = t.month();
+            if (day != nullptr)   *day   = t.day();
+            if (year != nullptr)  *year  = t.year();
         }
 
         /**
@@ -121,42 +176,74 @@ class DS3231rtc : public RTC_DS3231 {
             String *am_pm = nullptr, 
             T *hour = nullptr, T *minute = nullptr, T *second = nullptr
         ) {
+            DateTime t = this->now();
             if (!this->twelve_hour_format_flag) {
-                if (hour != nullptr)  *hour  = this->now().hour();
+                if (hour != nullptr)  *hour  = t.hour();
             } else {
-                if (am_pm != nullptr) *am_pm = (this->now().hour() < 12) ? "AM" : "PM";
-                if (hour != nullptr)  *hour  = this->twelve_hour_format(); 
+                if (am_pm != nullptr) *am_pm = (t.hour() < 12) ? "AM" : "PM";
+                if (hour != nullptr)  *hour  = this->twelve_hour_format(t); 
             }
 
-            if (minute != nullptr)   *minute = this->now().minute();
-            if (second != nullptr)   *second = this->now().second();
+            if (minute != nullptr)   *minute = t.minute();
+            if (second != nullptr)   *second = t.second();
         }
 
         /**
-         * @brief Get the current date as a formatter string (MM/DD/YYYY).
-         * @return `String` The formatted date string
+         * @brief Write the current date (MM/DD/YYYY) into a caller buffer.
+         * @param buf Buffer of at least RTC_DATE_LEN chars.
+         * @return `char*` The buffer, so the call can be used inline.
          */
-        String datestr(void) {
-            return String(this->now().month()) + "/"
-                + String(this->now().day()) + "/"
-                + String(this->now().year());
+        template <size_t N>
+        char *datestr(char (&buf)[N]) {
+            static_assert(N >= RTC_DATE_LEN, "date buffer too small");
+            DateTime t = this->now();
+            char *p = buf;
+            p = __digits__(p, t.month(), 1);  *p++ = '/';
+            p = __digits__(p, t.day(), 1);    *p++ = '/';
+            p = __digits__(p, t.year(), 4);   *p = '\0';
+            return buf;
         }
 
         /**
-         * @brief Get the current time as a formatted string (HH:MM:SS)
-         * @return `String` The formatted time string
+         * @brief Write the current time (HH:MM:SS, or HH:MM:SS AM/PM in 12-hour format) into a caller buffer.
+         * @param buf Buffer of at least RTC_TIME_LEN chars.
+         * @return `char*` The buffer, so the call can be used inline.
          */
-        String timestr(void) {
-            if (!this->twelve_hour_format_flag) {
-                return String(this->now().hour()) + ":"
-                    + String(this->now().minute()) + ":"
-                    + String(this->now().second());
+        template <size_t N>
+        char *timestr(char (&buf)[N]) {
+            static_assert(N >= RTC_TIME_LEN, "time buffer too small");
+            DateTime t = this->now();
+            char *p = buf;
+            p = __digits__(p, this->twelve_hour_format_flag ? this->twelve_hour_format(t) : t.hour(), 1);
+            *p++ = ':';
+            p = __digits__(p, t.minute(), 1); *p++ = ':';
+            p = __digits__(p, t.second(), 1);
+            if (this->twelve_hour_format_flag) {
+                *p++ = ' ';
+                *p++ = (t.hour() < 12) ? 'A' : 'P';
+                *p++ = 'M';
             }
+            *p = '\0';
+            return buf;
+        }
 
-            return String(this->twelve_hour_format()) + ":"
-                + String(this->now().minute()) + ":"
-                + String(this->now().second()) + " "
-                + (this->now().hour() < 12 ? "AM" : "PM");
+        /**
+         * @brief Write the current date and time as zero-padded ISO 8601 (YYYY-MM-DDTHH:MM:SS).
+         * @param buf Buffer of at least RTC_ISO8601_LEN chars.
+         * @return `char*` The buffer, so the call can be used inline.
+         */
+        template <size_t N>
+        char *iso8601(char (&buf)[N]) {
+            static_assert(N >= RTC_ISO8601_LEN, "ISO 8601 buffer too small");
+            DateTime t = this->now();
+            char *p = buf;
+            p = __digits__(p, t.year(), 4);   *p++ = '-';
+            p = __digits__(p, t.month(), 2);  *p++ = '-';
+            p = __digits__(p, t.day(), 2);    *p++ = 'T';
+            p = __digits__(p, t.hour(), 2);   *p++ = ':';
+            p = __digits__(p, t.minute(), 2); *p++ = ':';
+            p = __digits__(p, t.second(), 2); *p = '\0';
+            return buf;
         }
 
 
@@ -167,7 +254,25 @@ class DS3231rtc : public RTC_DS3231 {
                 "Saturday"
             };
 
-            uint8_t twelve_hour_format() { // convert the hour component to 12-hours format
-                return (this->now().hour() > 12) ? this->now().hour() - 12 : (this->now().hour() == 0) ? 12 : this->now().hour();
+            portMUX_TYPE __mux__ = portMUX_INITIALIZER_UNLOCKED; ///< Guards the cached clock
+            uint32_t __syncTime__ = 0;      ///< Unix time of the last RTC read
+            uint32_t __syncMillis__ = 0;    ///< millis() at the last RTC read
+            bool __synced__ = false;        ///< Cached clock is valid
+
+            // Write `value` in decimal, left-padded with zeros to `width` digits (max 5)
+            static char *__digits__(char *p, uint16_t value, uint8_t width) {
+                char tmp[5];
+                uint8_t n = 0;
+                do {
+                    tmp[n++] = '0' + value % 10;
+                    value /= 10;
+                } while (value != 0 && n < sizeof(tmp));
+                while (n < width && n < sizeof(tmp)) tmp[n++] = '0';
+                while (n != 0) *p++ = tmp[--n];
+                return p;
+            }
+
+            uint8_t twelve_hour_format(const DateTime &t) { // convert the hour component to 12-hours format
+                return (t.hour() > 12) ? t.hour() - 12 : (t.hour() == 0) ? 12 : t.hour();
             }
 };
@@ -103,10 +103,8 @@ class EraseEEPROM {
             if (this->__process) return true;      // Prevent re-execution if already processed
 
         #if defined(ESP32) || defined(ESP8266)
-            // For ESP platforms
-            for (size_t i = 0; i < this->__eeprom_size; i++) {
-                EEPROM.write(i, 0);
-            }
+            // For ESP platforms, clear the RAM buffer in one go and commit it once
+            memset(EEPROM.getDataPtr(), 0, this->__eeprom_size);
             this->__process = EEPROM.commit(); // Commit changes to EEPROM
         #else
             // For Arduino platforms
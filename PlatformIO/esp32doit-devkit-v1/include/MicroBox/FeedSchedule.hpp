@@ -0,0 +1,130 @@
+/**
+ *  @file FeedSchedule.hpp
+ *  @version 1.0.0
+ *  @brief Feeding schedule stored as seconds-of-day with day-of-week masks.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+#define SECONDS_PER_DAY 86400UL
+
+// Day-of-week mask bits, same numbering as DateTime::dayOfTheWeek() (0 = Sunday)
+#define FEED_SUN        (1 << 0)
+#define FEED_MON        (1 << 1)
+#define FEED_TUE        (1 << 2)
+#define FEED_WED        (1 << 3)
+#define FEED_THU        (1 << 4)
+#define FEED_FRI        (1 << 5)
+#define FEED_SAT        (1 << 6)
+#define FEED_WEEKDAYS   (FEED_MON | FEED_TUE | FEED_WED | FEED_THU | FEED_FRI)
+#define FEED_EVERYDAY   0x7F
+
+/// Build a seconds-of-day value from a 24-hour clock time
+#define FEED_AT(hour, minute, second) ((uint32_t)(hour) * 3600UL + (uint32_t)(minute) * 60UL + (uint32_t)(second))
+
+/**
+ * @brief One schedule entry.
+ */
+struct FeedEntry {
+    uint32_t second;    ///< Seconds since midnight (0 - 86399)
+    uint8_t days;       ///< Day-of-week mask (FEED_SUN ... FEED_SAT)
+};
+
+/**
+ * @class FeedSchedule
+ * @brief Sorted table of feeding times that answers "when is the next feed?".
+ * 
+ * Entries are copied and sorted by time of day once, at construction. The
+ * next due event after a given unix time is found with a binary search in
+ * the current day, then by walking forward day by day until an entry whose
+ * mask includes that weekday is found (at most 8 days are looked at).
+ * All times are local unix seconds as returned by DateTime::unixtime().
+ */
+class FeedSchedule {
+    public:
+        /**
+         * @brief Build the schedule from a table of entries.
+         * @param entries Entry table, in any order.
+         * @param count Number of entries; extra entries above FEED_SCHEDULE_MAX are ignored.
+         */
+        FeedSchedule(const FeedEntry *entries, uint8_t count) {
+            this->__count__ = 0;
+            for (uint8_t i = 0; i < count && this->__count__ < FEED_SCHEDULE_MAX; i++) {
+                if (entries[i].second >= SECONDS_PER_DAY || (entries[i].days & FEED_EVERYDAY) == 0) continue;
+
+                // Insertion sort, the table is tiny and only built once
+                uint8_t j = this->__count__++;
+                while (j > 0 && this->__entries__[j - 1].second > entries[i].second) {
+                    this->__entries__[j] = this->__entries__[j - 1];
+                    j--;
+                }
+                this->__entries__[j] = entries[i];
+            }
+        }
+
+        /**
+         * @brief Find the first due event strictly after a point in time.
+         * @param now Current time in unix seconds.
+         * @return Unix time of the next event, 0 if the schedule is empty.
+         */
+        uint32_t nextAfter(uint32_t now) const {
+            uint32_t midnight = now - now % SECONDS_PER_DAY;
+            uint8_t weekday = (now / SECONDS_PER_DAY + 4) % 7; // 1970-01-01 was a Thursday
+
+            for (uint8_t day = 0; day <= 7; day++) {
+                uint8_t mask = 1 << ((weekday + day) % 7);
+                uint8_t i = (day == 0) ? this->upperBound(now % SECONDS_PER_DAY) : 0;
+
+                for (; i < this->__count__; i++) {
+                    if (this->__entries__[i].days & mask) {
+                        return midnight + day * SECONDS_PER_DAY + this->__entries__[i].second;
+                    }
+                }
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Number of valid entries in the schedule.
+         */
+        uint8_t size() const {
+            return this->__count__;
+        }
+
+    private:
+        FeedEntry __entries__[FEED_SCHEDULE_MAX];
+        uint8_t __count__;
+
+        // Index of the first entry later than `second`
+        uint8_t upperBound(uint32_t second) const {
+            uint8_t low = 0, high = this->__count__;
+            while (low < high) {
+                uint8_t mid = (low + high) / 2;
+                if (this->__entries__[mid].second <= second) low = mid + 1;
+                else high = mid;
+            }
+            return low;
+        }
+};
@@ -29,8 +29,60 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Configure the DS3231 alarm interrupt and arm the feeding schedule.
+ * @details Call once from the task that runs FeederSys_run(), after the RTC is started.
+ */
+void FeederSys_begin();
+
 void FeederSys_run();
 
+/**
+ * @brief Recompute the next scheduled feed, e.g. after the RTC time was adjusted.
+ * @details Safe to call from any task; the alarm is reprogrammed on the next FeederSys_run().
+ */
+void FeederSys_rearmSchedule();
+
+/**
+ * @brief Check whether a feed cycle is in progress.
+ * @return `true` while the feeder is not idle.
+ */
+bool FeederSys_busy();
+
+/**
+ * @brief Check whether a feed request is held back by the sensor readings.
+ * @details While `true` the next sample can start the feed, so vTask1 wakes vTask3 on every sample.
+ * @return `true` while a manual feed waits for the capacity or turbidity check.
+ */
+bool FeederSys_awaitingSensor();
+
+/**
+ * @brief Relay decision for one sample: on when the water is turbid or the pH is out of range.
+ * @param ph pH value.
+ * @param ntu Turbidity in NTU.
+ * @return `true` if the relay should be on.
+ */
+bool FeederSys_relayWanted(float ph, float ntu);
+
+/**
+ * @brief Relay state last written by FeederSys_run().
+ * @details vTask1 wakes vTask3 as soon as a sample's FeederSys_relayWanted() differs from it.
+ * @return `true` while the relay is on.
+ */
+bool FeederSys_relayOn();
+
+/**
+ * @brief Time until the feeder needs the next FeederSys_run() call.
+ * @return Milliseconds, `UINT32_MAX` when idle.
+ */
+uint32_t FeederSys_nextDeadline();
+
+/**
+ * @brief Worst-case execution time of FeederSys_run() since boot.
+ * @return Time in microseconds.
+ */
+uint32_t FeederSys_worstLoopTime();
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,208 @@
+/**
+ *  @file Logger.h
+ *  @version 1.0.0
+ *  @brief Leveled serial logger that never blocks the caller.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+
+// Log levels, LOGGER_LEVEL in config.h (or -DLOGGER_LEVEL) sets the highest one compiled in
+#define LOGGER_LEVEL_NONE   0
+#define LOGGER_LEVEL_ERROR  1
+#define LOGGER_LEVEL_WARN   2
+#define LOGGER_LEVEL_INFO   3
+#define LOGGER_LEVEL_DEBUG  4
+
+#include "config.h"
+
+// With -DLOGGER_BINARY only a hash of level, tag and format is kept in the
+// firmware; log_strings.py writes the table that log_decode.py renders with
+#ifdef LOGGER_BINARY
+#define LOGGER_EMIT(level, tag, format, ...) \
+    Logger.writeBinary(std::integral_constant<uint32_t, LoggerClass::hash(level, tag, format)>::value, ##__VA_ARGS__)
+#else
+#define LOGGER_EMIT(level, tag, ...) Logger.write(level, tag, __VA_ARGS__)
+#endif
+
+#if LOGGER_LEVEL >= LOGGER_LEVEL_ERROR
+#define LOG_ERROR(tag, ...) LOGGER_EMIT(LOGGER_LEVEL_ERROR, tag, __VA_ARGS__)
+#else
+#define LOG_ERROR(tag, ...) ((void)0)
+#endif
+
+#if LOGGER_LEVEL >= LOGGER_LEVEL_WARN
+#define LOG_WARN(tag, ...)  LOGGER_EMIT(LOGGER_LEVEL_WARN, tag, __VA_ARGS__)
+#else
+#define LOG_WARN(tag, ...)  ((void)0)
+#endif
+
+#if LOGGER_LEVEL >= LOGGER_LEVEL_INFO
+#define LOG_INFO(tag, ...)  LOGGER_EMIT(LOGGER_LEVEL_INFO, tag, __VA_ARGS__)
+#else
+#define LOG_INFO(tag, ...)  ((void)0)
+#endif
+
+#if LOGGER_LEVEL >= LOGGER_LEVEL_DEBUG
+#define LOG_DEBUG(tag, ...) LOGGER_EMIT(LOGGER_LEVEL_DEBUG, tag, __VA_ARGS__)
+#else
+#define LOG_DEBUG(tag, ...) ((void)0)
+#endif
+
+#define LOGGER_FRAME_SYNC   0xA5    ///< First byte of a binary frame, never part of ASCII text
+
+/**
+ * @class LoggerClass
+ * @brief Formats records into a lock-free ring that a low-priority task prints.
+ * 
+ * `write()` reserves a slot with one compare-and-swap on the head, formats
+ * the text into it and marks it ready; it never waits on the UART or on a
+ * lock. When all LOGGER_SLOTS are taken the record is dropped and counted.
+ * The drain task runs at idle priority every LOGGER_DRAIN_MS and prints
+ * the ready slots in order as `[millis][level][tag] text`, so a full UART
+ * TX buffer only ever stalls the drain task.
+ * 
+ * Use the LOG_ERROR/LOG_WARN/LOG_INFO/LOG_DEBUG macros with a short module
+ * tag; levels above LOGGER_LEVEL cost nothing, not even the arguments.
+ * 
+ * Binary mode (-DLOGGER_BINARY): the macros pass a compile-time FNV-1a hash
+ * of level, tag and format instead of the strings, and `writeBinary()` only
+ * copies the raw arguments: integers and pointers as 4 bytes, floating point
+ * as a 4-byte float, strings as a length byte plus the characters. The
+ * drain task sends each record as one frame:
+ * 
+ *     0xA5 | payload length (1) | id (4) | millis (4) | payload
+ * 
+ * all little-endian. Text written directly to Serial passes through as is.
+ */
+class LoggerClass {
+    public:
+        /**
+         * @brief Start the drain task. Records written before are kept.
+         */
+        void begin();
+
+        /**
+         * @brief Queue one record. Safe from any task, not from an ISR.
+         * @param level LOGGER_LEVEL_ERROR .. LOGGER_LEVEL_DEBUG.
+         * @param tag Module tag, must be a string literal.
+         * @param format printf format of the text.
+         * @return `false` if the ring was full and the record was dropped.
+         */
+        bool write(uint8_t level, const char *tag, const char *format, ...) __attribute__((format(printf, 4, 5)));
+
+        /**
+         * @brief Queue one binary record. Safe from any task, not from an ISR.
+         * @param id Hash of the call site, see `hash()`.
+         * @param args The format arguments, copied without formatting.
+         * @return `false` if the ring was full and the record was dropped.
+         */
+        template <typename... Args>
+        bool writeBinary(uint32_t id, const Args &...args) {
+            uint32_t index;
+            Slot *slot = this->__reserve__(index);
+            if (slot == nullptr) return false;
+
+            slot->id = id;
+            slot->length = 0;
+            (this->__pack__(*slot, args), ...);
+            this->__commit__(*slot, index);
+            return true;
+        }
+
+        /**
+         * @brief FNV-1a over level, tag, a zero byte and format; log_strings.py must match.
+         */
+        static constexpr uint32_t hash(uint8_t level, const char *tag, const char *format) {
+            uint32_t h = (2166136261UL ^ level) * 16777619UL;
+            while (*tag) h = (h ^ (uint8_t)*tag++) * 16777619UL;
+            h = h * 16777619UL;
+            while (*format) h = (h ^ (uint8_t)*format++) * 16777619UL;
+            return h;
+        }
+
+        uint32_t written() const { return this->__written__; }  ///< Records queued since boot
+        uint32_t dropped() const { return this->__dropped__; }  ///< Records lost to a full ring
+
+    private:
+        struct Slot {
+            std::atomic<uint32_t> seq;      ///< Index + 1 of the record once it is ready
+            uint32_t millis;                ///< Time of the write() call
+            uint8_t level;
+            const char *tag;
+            uint32_t id;                    ///< Binary mode: call site hash
+            uint8_t length;                 ///< Binary mode: payload bytes in `text`
+            char text[LOGGER_RECORD_LEN];   ///< Text, or the binary payload
+        };
+
+        Slot *__reserve__(uint32_t &index);
+        void __commit__(Slot &slot, uint32_t index);
+
+        void __put__(Slot &slot, const void *data, size_t length) {
+            if (slot.length + length > sizeof(slot.text)) return;   // Decoder shows the missing argument
+            memcpy(slot.text + slot.length, data, length);
+            slot.length += length;
+        }
+
+        template <typename T>
+        void __pack__(Slot &slot, const T &value) {
+            if constexpr (std::is_floating_point<T>::value) {
+                float v = value;
+                this->__put__(slot, &v, sizeof(v));
+            }
+            else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+                uint32_t v = (uint32_t)value;
+                this->__put__(slot, &v, sizeof(v));
+            }
+            else if constexpr (std::is_convertible<const T &, const char *>::value) {
+                const char *str = value;
+                size_t room = sizeof(slot.text) - slot.length;
+                if (room == 0) return;
+                uint8_t length = min(strlen(str), min(room - 1, (size_t)UINT8_MAX));
+                slot.text[slot.length++] = length;
+                this->__put__(slot, str, length);
+            }
+            else {
+                uint32_t v = (uint32_t)(uintptr_t)value;
+                this->__put__(slot, &v, sizeof(v));
+            }
+        }
+
+        static void __task__(void *pvParameter);
+        void __drain__();
+        void __emit__(const Slot &slot);
+
+        Slot __slots__[LOGGER_SLOTS] = {};
+        std::atomic<uint32_t> __head__{0};  ///< Next index to reserve
+        std::atomic<uint32_t> __tail__{0};  ///< Next index to print
+        std::atomic<uint32_t> __written__{0};
+        std::atomic<uint32_t> __dropped__{0};
+        uint32_t __reported__ = 0;          ///< Drops already reported by the drain task
+        TaskHandle_t __taskHandle__ = NULL;
+};
+
+#if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_Logger)
+extern LoggerClass Logger;
+#endif
@@ -27,6 +27,8 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "ADCSampler.h"
+#include "SensorKernels.hpp"
 
 /**
  * @class PHSensorClass
@@ -34,7 +36,7 @@
  */
 class PHSensorClass {
     public:
-        uint16_t ADC_value; // ADC value read from the pH sensor
+        uint16_t ADC_value = 0; // ADC value read from the pH sensor
         float voltage;      // Voltage calculated from the ADC value
         float PH_value;     // Calculated pH value
 
@@ -53,17 +55,23 @@ class PHSensorClass {
          */
         void run() {
             // Read the ADC value from the sensor.
-            this->ADC_value = analogRead(this->_pinout);
+            this->ADC_value = this->readADC();
 
-            // Calculate the voltage
-            this->voltage = this->ADC_value * (VOLTAGE_REF / ADC_RESOLUTION);
-            // Calculate the pH step value
-            float PH_Steps = (PH4 - PH7) / 3;
-
-            // Calculate the pH value based on voltage
-            this->PH_value = 7.0 + ((PH7 - this->voltage) / PH_Steps); 
+            // Calculate the voltage and pH value (fixed-point, calibration folded at compile time)
+            this->voltage  = AdcToMillivolt::apply(this->ADC_value) / 1000.0f;
+            this->PH_value = AdcToMilliPH::apply(this->ADC_value) / 1000.0f;
         }
 
     private:
         uint8_t _pinout;
+
+        /**
+         * @brief Take the oversampled value from the ADC sampler when it runs,
+         *        otherwise fall back to a single blocking conversion.
+         */
+        uint16_t readADC() {
+            uint16_t value;
+            if (ADCSampler.read(this->_pinout, value)) return value;
+            return ADCSampler.running() ? this->ADC_value : analogRead(this->_pinout);
+        }
 };
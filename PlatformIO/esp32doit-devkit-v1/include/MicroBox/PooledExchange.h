@@ -0,0 +1,100 @@
+/**
+ *  @file PooledExchange.h
+ *  @version 1.0.0
+ *  @brief WebExchange that serves small response bodies from ResponsePool.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "WebExchange.h"
+#include "ResponsePool.hpp"
+
+/**
+ * @class PooledExchange
+ * @brief Puts JSON and binary bodies into a ResponsePool slot when one is free.
+ * 
+ * The transport only sends a slot and releases it once the connection is
+ * done with it, or opens a heap-backed stream when the pool is exhausted
+ * or the body does not fit. AsyncWebExchange is the device transport; the
+ * native tests run the same pool path against a mock.
+ */
+class PooledExchange : public WebExchange {
+    public:
+        JsonSink &beginJson(int code, size_t len) override {
+            this->__code__ = code;
+            this->__slot__ = len <= RESPONSE_POOL_SLOT_SIZE ? ResponsePool::acquire() : nullptr;
+            if (this->__slot__ == nullptr) return this->__beginStream__(code, APPJSON, len);
+
+            this->__sink__ = BufferSink(this->__slot__, RESPONSE_POOL_SLOT_SIZE);
+            return this->__sink__;
+        }
+
+        void endJson() override {
+            if (this->__slot__ == nullptr) {
+                this->__endStream__();
+                return;
+            }
+            this->__sendSlot__(this->__code__, APPJSON, this->__slot__, this->__sink__.length());
+        }
+
+        void send(int code, const char *mime, const uint8_t *data, size_t len) override {
+            // Copied either way, the caller's buffer may be gone before it is sent
+            char *slot = len <= RESPONSE_POOL_SLOT_SIZE ? ResponsePool::acquire() : nullptr;
+            if (slot == nullptr) {
+                this->__beginStream__(code, mime, len).write(data, len);
+                this->__endStream__();
+                return;
+            }
+
+            memcpy(slot, data, len);
+            this->__sendSlot__(code, mime, slot, len);
+        }
+
+    protected:
+        /**
+         * @brief Send a pool slot as the body.
+         * @param code HTTP status code.
+         * @param mime Content type.
+         * @param slot Body, must go back with ResponsePool::release() once it has been sent.
+         * @param len Body length.
+         */
+        virtual void __sendSlot__(int code, const char *mime, char *slot, size_t len) = 0;
+
+        /**
+         * @brief Open a heap-backed response for a body that is not pooled.
+         * @return The sink to write the body into; finish with __endStream__().
+         */
+        virtual JsonSink &__beginStream__(int code, const char *mime, size_t len) = 0;
+
+        /**
+         * @brief Send the response opened by __beginStream__().
+         */
+        virtual void __endStream__() = 0;
+
+    private:
+        int __code__ = 200;         ///< Status code of the JSON response
+        char *__slot__ = nullptr;   ///< Pool slot of the JSON body, `nullptr` when streaming
+        BufferSink __sink__;        ///< Writes into `__slot__`
+};
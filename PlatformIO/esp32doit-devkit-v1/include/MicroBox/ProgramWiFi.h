@@ -30,6 +30,7 @@
 #include "MyEEPROM.hpp"
 #include "BootButton.h"
 #include "variable.h"
+#include "Logger.h"
 
 class ProgramWiFiClass {
     public:
@@ -52,7 +53,7 @@ class ProgramWiFiClass {
          *  @param state Mode_AP = `true` or Mode_STA = `false`
          */
         void initWiFi(bool state) {
-            Serial.printf("\nMode WiFi: %s\n", state ? "WIFI_STA" : "WIFI_AP");
+            LOG_INFO("wifi", "Mode WiFi: %s", state ? "WIFI_STA" : "WIFI_AP");
             if (state) {
                 this->__wifi_mode_sta__();
             }
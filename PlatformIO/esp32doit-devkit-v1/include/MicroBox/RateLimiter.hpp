@@ -0,0 +1,90 @@
+/**
+ *  @file RateLimiter.hpp
+ *  @version 1.0.0
+ *  @brief Token-bucket rate limiter keyed by client IPv4 address.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @class RateLimiter
+ * @brief Fixed table of RATE_LIMIT_CLIENTS token buckets, one per client IP.
+ * 
+ * Each bucket holds up to RATE_LIMIT_BURST tokens and refills at
+ * RATE_LIMIT_PER_S tokens per second; a request takes as many tokens as
+ * its route costs. An unknown IP replaces the least recently seen one and
+ * starts with a full bucket. Tokens are kept in thousandths, so the refill
+ * is exact at millisecond resolution without floating point.
+ */
+class RateLimiter {
+    public:
+        /**
+         * @brief Take tokens for one request.
+         * @param ip Client IPv4 address.
+         * @param cost Tokens the request costs.
+         * @return `false` if the bucket does not hold enough tokens; nothing is taken then.
+         */
+        bool allow(uint32_t ip, uint16_t cost) {
+            uint32_t now = millis();
+            bool allowed = false;
+
+            portENTER_CRITICAL(&this->__mux__);
+            Bucket *bucket = &this->__buckets__[0];
+            for (auto &b : this->__buckets__) {
+                if (b.ip == ip) { bucket = &b; break; }
+                if ((uint32_t)(now - b.last) > (uint32_t)(now - bucket->last)) bucket = &b;
+            }
+            if (bucket->ip != ip) {
+                bucket->ip = ip;
+                bucket->tokens = __FULL__;
+            } else {
+                // Past a full refill the product would overflow after ~10 days idle
+                uint32_t elapsed = now - bucket->last;
+                if (elapsed > __FULL__ / RATE_LIMIT_PER_S) elapsed = __FULL__ / RATE_LIMIT_PER_S;
+                uint32_t refill = elapsed * RATE_LIMIT_PER_S;
+                bucket->tokens = refill >= __FULL__ - bucket->tokens ? __FULL__ : bucket->tokens + refill;
+            }
+            bucket->last = now;
+
+            if (bucket->tokens >= (uint32_t)cost * 1000) {
+                bucket->tokens -= (uint32_t)cost * 1000;
+                allowed = true;
+            }
+            portEXIT_CRITICAL(&this->__mux__);
+            return allowed;
+        }
+
+    private:
+        static constexpr uint32_t __FULL__ = RATE_LIMIT_BURST * 1000UL;
+
+        struct Bucket {
+            uint32_t ip;        ///< Client address, 0 if unused
+            uint32_t tokens;    ///< Tokens x 1000
+            uint32_t last;      ///< millis() of the last request
+        };
+
+        Bucket __buckets__[RATE_LIMIT_CLIENTS] = {};
+        portMUX_TYPE __mux__ = portMUX_INITIALIZER_UNLOCKED; ///< Guards `__buckets__`
+};
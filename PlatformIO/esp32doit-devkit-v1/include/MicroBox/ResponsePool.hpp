@@ -0,0 +1,107 @@
+/**
+ *  @file ResponsePool.hpp
+ *  @version 1.0.0
+ *  @brief Fixed pool of response buffers for the JSON endpoints.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include "config.h"
+
+/**
+ * @class ResponsePool
+ * @brief Static pool of RESPONSE_POOL_SLOTS buffers of RESPONSE_POOL_SLOT_SIZE bytes.
+ * 
+ * A response (JSON or binary) is written into a slot and handed to the web
+ * server as the body; the slot is released when the connection closes. The
+ * slots live in .bss, so a response costs no heap for its body. Callers
+ * fall back to a heap-backed stream when every slot is busy. Only uses the
+ * standard library, the native tests run the same code.
+ */
+class ResponsePool {
+    public:
+        /**
+         * @brief Take a free slot.
+         * @return The slot, or `nullptr` if all slots are in use.
+         */
+        static char *acquire() {
+            ResponsePool &pool = instance();
+            uint32_t used = pool.__used__.load(std::memory_order_relaxed);
+            for (;;) {
+                uint8_t i = 0;
+                while (i < RESPONSE_POOL_SLOTS && (used & (1UL << i))) i++;
+                if (i == RESPONSE_POOL_SLOTS) {
+                    pool.__exhausted__.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                // Another task may have taken the same slot since the load, then retry
+                if (pool.__used__.compare_exchange_weak(used, used | (1UL << i), std::memory_order_acquire, std::memory_order_relaxed)) {
+                    return pool.__slots__[i];
+                }
+            }
+        }
+
+        /**
+         * @brief Return a slot taken with acquire().
+         * @param slot The slot; ignored if it does not belong to the pool.
+         */
+        static void release(char *slot) {
+            ResponsePool &pool = instance();
+            for (uint8_t i = 0; i < RESPONSE_POOL_SLOTS; i++) {
+                if (slot == pool.__slots__[i]) {
+                    pool.__used__.fetch_and(~(1UL << i), std::memory_order_release);
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief Number of acquire() calls that found no free slot.
+         * @return `uint32_t` Count since boot.
+         */
+        static uint32_t exhausted() { return instance().__exhausted__.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Number of slots in use.
+         */
+        static uint8_t inUse() {
+            uint32_t used = instance().__used__.load(std::memory_order_relaxed);
+            uint8_t count = 0;
+            for (uint8_t i = 0; i < RESPONSE_POOL_SLOTS; i++) count += (used >> i) & 1;
+            return count;
+        }
+
+    private:
+        static_assert(RESPONSE_POOL_SLOTS <= 32, "ResponsePool: one bit per slot in a 32-bit mask");
+
+        static ResponsePool &instance() {
+            static ResponsePool instance;
+            return instance;
+        }
+
+        char __slots__[RESPONSE_POOL_SLOTS][RESPONSE_POOL_SLOT_SIZE] = {}; ///< Response bodies
+        std::atomic<uint32_t> __used__{0};          ///< Bit mask of slots in use
+        std::atomic<uint32_t> __exhausted__{0};     ///< Failed acquire() calls
+};
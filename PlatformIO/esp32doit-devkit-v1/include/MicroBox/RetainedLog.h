@@ -0,0 +1,134 @@
+/**
+ *  @file RetainedLog.h
+ *  @version 1.0.0
+ *  @brief Sample and event ring in RTC slow memory that survives soft resets.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "config.h"
+#include "SeriesStore.h"
+
+/**
+ * @brief Why the board restarted, recorded once per boot.
+ */
+enum RebootReason : uint8_t {
+    REBOOT_UNKNOWN,         ///< Reset cause not reported by the chip
+    REBOOT_POWER_ON,        ///< Power-on or external reset, the retained data is gone
+    REBOOT_SOFTWARE,        ///< ESP.restart() without a recorded reason (e.g. OTA)
+    REBOOT_PANIC,           ///< Exception or abort
+    REBOOT_WATCHDOG,        ///< Interrupt or task watchdog
+    REBOOT_BROWNOUT,        ///< Supply voltage dropped
+    REBOOT_WEB,             ///< `/rst-webserver`
+    REBOOT_ENABLE_BLYNK,    ///< `/enable-blynk`
+    REBOOT_WIFI_OFFLINE,    ///< AutoChangeState, Wi-Fi lost for too long
+    REBOOT_BUTTON,          ///< Boot button switched the Wi-Fi mode
+    REBOOT_REASON_COUNT
+};
+
+/**
+ * @brief Kinds of retained events.
+ */
+enum RetainedEventKind : uint8_t {
+    RETAINED_EVT_BOOT = 1,  ///< Board started, `arg` is the RebootReason
+    RETAINED_EVT_FEED       ///< Feed cycle started, `arg` is 1 for scheduled, 0 for manual
+};
+
+/**
+ * @brief One retained event.
+ */
+struct RetainedEvent {
+    uint32_t time;          ///< RTC time, unix seconds
+    uint8_t kind;           ///< RetainedEventKind
+    uint8_t arg;            ///< Kind specific argument
+    uint16_t check;         ///< Checksum of the fields above
+};
+
+/**
+ * @class RetainedLog
+ * @brief Rings of the latest series records and events in `RTC_NOINIT` memory.
+ * 
+ * RTC slow memory keeps its content over every reset except power-on, and
+ * `RTC_NOINIT_ATTR` stops the startup code from clearing it. SeriesStore
+ * copies every closed record here as well, so the records still waiting in
+ * its RAM queue survive a restart; at the next boot SeriesStore::begin()
+ * appends the ones newer than its files. Feed cycles and the reason of each
+ * reboot are kept in a second ring. Nothing is written to flash on restart.
+ * 
+ * Every entry carries a checksum, so one cut short by a crash is skipped
+ * instead of merged.
+ */
+class RetainedLog {
+    public:
+        /**
+         * @brief Validate the retained area and record why the board started.
+         * Must run before SeriesStore::begin().
+         * @param now RTC time, unix seconds.
+         */
+        static void begin(uint32_t now);
+
+        /**
+         * @brief Keep one closed series record.
+         * @param record The record SeriesStore queued for writing.
+         */
+        static void sample(const SeriesRecord &record);
+
+        /**
+         * @brief Keep one event.
+         * @param kind Event kind.
+         * @param arg Kind specific argument.
+         * @param time RTC time, unix seconds.
+         */
+        static void event(RetainedEventKind kind, uint8_t arg, uint32_t time);
+
+        /**
+         * @brief Remember the reason for the next software restart.
+         * @param reason Reported as the boot reason after ESP.restart().
+         */
+        static void setReason(RebootReason reason);
+
+        /**
+         * @brief Record the reason and restart the board.
+         * @param reason Reported as the boot reason after the restart.
+         */
+        [[noreturn]] static void restart(RebootReason reason);
+
+        /**
+         * @brief Pass the retained records to a callback, oldest first.
+         * @param from Skip records with a time before this, unix seconds.
+         * @param callback Called for each valid record.
+         * @return Number of records passed to the callback.
+         */
+        static size_t samples(uint32_t from, const std::function<void(const SeriesRecord &)> &callback);
+
+        /**
+         * @brief Pass the retained events to a callback, oldest first.
+         * @param callback Called for each valid event.
+         * @return Number of events passed to the callback.
+         */
+        static size_t events(const std::function<void(const RetainedEvent &)> &callback);
+
+        static RebootReason bootReason();                   ///< Reason of the current boot
+        static const char *reasonName(RebootReason reason); ///< Short name for the serial log
+};
@@ -0,0 +1,297 @@
+/**
+ *  @file SensorHistory.hpp
+ *  @version 1.0.0
+ *  @brief Fixed-memory, multi-resolution history of the sensor values.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+#include "SensorSnapshot.hpp"
+
+/**
+ * @brief Metrics kept in the history.
+ */
+enum HistoryMetric : uint8_t {
+    HISTORY_PH,         ///< "ph", stored x 100
+    HISTORY_NTU,        ///< "ntu", stored x 10
+    HISTORY_CAPACITY,   ///< "capacity", stored x 100
+    HISTORY_METRIC_COUNT
+};
+
+/**
+ * @brief Resolutions kept in the history.
+ */
+enum HistoryRes : uint8_t {
+    HISTORY_RAW,        ///< "raw": every published sample
+    HISTORY_MINUTE,     ///< "1m": 1-minute min/max/avg
+    HISTORY_HOUR,       ///< "1h": 1-hour min/max/avg
+    HISTORY_RES_COUNT
+};
+
+/**
+ * @brief One decoded history point. Raw points have min == max == avg.
+ */
+struct HistoryPoint {
+    uint32_t time;  ///< Start of the bucket (raw: sample time), unix seconds
+    float min;
+    float max;
+    float avg;
+};
+
+/**
+ * @class SensorHistory
+ * @brief Three ring buffers of raw samples and 1-minute / 1-hour rollups.
+ * 
+ * Values are stored as scaled int16 to keep the rings small:
+ * 
+ *  | Ring   | Entry    | Entries            | RAM       |
+ *  |--------|----------|--------------------|-----------|
+ *  | raw    | 12 bytes | HISTORY_RAW_LEN    | 2.8 KB    |
+ *  | 1m     | 24 bytes | HISTORY_MINUTE_LEN | 8.4 KB    |
+ *  | 1h     | 24 bytes | HISTORY_HOUR_LEN   | 3.9 KB    |
+ * 
+ * Every entry has an absolute index (number of entries written before it).
+ * A reader keeps such an index as its cursor, so it can stream a range in
+ * pieces while the sensor task keeps writing; entries overwritten in the
+ * meantime are skipped. Each ring is sorted by time, so the start of a
+ * range is found by binary search: a query costs O(log n) plus one short
+ * critical section per returned point.
+ * 
+ * The RTC can step back (a DS3231 sync, or the time set by hand). A step of
+ * up to HISTORY_CLOCK_SLACK_S is absorbed by stamping the samples with the
+ * last time; a larger one starts all rings over, as the old entries belong
+ * to another timeline.
+ */
+class SensorHistory {
+    public:
+        /**
+         * @brief Append one sample and update the rollups. Only one task may call this.
+         * @param sample The published sample set.
+         * @param unixtime RTC time of the sample, unix seconds.
+         */
+        void add(const SensorSample &sample, uint32_t unixtime) {
+            // Keep the rings sorted for lowerBound()
+            if (unixtime < this->__last__) {
+                if (this->__last__ - unixtime <= HISTORY_CLOCK_SLACK_S) unixtime = this->__last__;
+                else this->__restart__();
+            }
+            this->__last__ = unixtime;
+
+            int16_t values[HISTORY_METRIC_COUNT] = {
+                encode(HISTORY_PH, sample.ph),
+                encode(HISTORY_NTU, sample.ntu),
+                encode(HISTORY_CAPACITY, sample.capacity)
+            };
+
+            RawEntry raw = { unixtime, {} };
+            memcpy(raw.value, values, sizeof(values));
+
+            // Close the buckets that ended before this sample
+            RollupEntry minute, hour;
+            bool minuteDone = this->__minute__.count > 0 && unixtime / 60 != this->__minute__.time / 60;
+            if (minuteDone) {
+                minute = this->__minute__.entry();
+                this->__minute__ = Bucket{};
+            }
+            bool hourDone = this->__hour__.count > 0 && unixtime / 3600 != this->__hour__.time / 3600;
+            if (hourDone) {
+                hour = this->__hour__.entry();
+                this->__hour__ = Bucket{};
+            }
+            this->__minute__.add(unixtime - unixtime % 60, values);
+            this->__hour__.add(unixtime - unixtime % 3600, values);
+
+            portENTER_CRITICAL(&this->__mux__);
+            this->__raw__[this->__head__[HISTORY_RAW]++ % HISTORY_RAW_LEN] = raw;
+            if (minuteDone) this->__minutes__[this->__head__[HISTORY_MINUTE]++ % HISTORY_MINUTE_LEN] = minute;
+            if (hourDone) this->__hours__[this->__head__[HISTORY_HOUR]++ % HISTORY_HOUR_LEN] = hour;
+            portEXIT_CRITICAL(&this->__mux__);
+        }
+
+        /**
+         * @brief Find the first entry at or after a time.
+         * @param res Resolution to search.
+         * @param from Unix seconds.
+         * @return Absolute index to pass to read() as the cursor.
+         */
+        uint32_t lowerBound(HistoryRes res, uint32_t from) {
+            portENTER_CRITICAL(&this->__mux__);
+            uint32_t head = this->__head__[res];
+            uint32_t low = this->__tail__(res, head);
+            uint32_t high = head;
+            while (low < high) {
+                uint32_t mid = low + (high - low) / 2;
+                if (this->__timeAt__(res, mid) < from) low = mid + 1;
+                else high = mid;
+            }
+            portEXIT_CRITICAL(&this->__mux__);
+            return low;
+        }
+
+        /**
+         * @brief Read the entry at the cursor and advance the cursor.
+         * @param res Resolution to read.
+         * @param metric Metric to decode.
+         * @param cursor Absolute index; moved past overwritten entries.
+         * @param out The decoded point.
+         * @return `false` if there is no entry at or after the cursor yet.
+         */
+        bool read(HistoryRes res, HistoryMetric metric, uint32_t &cursor, HistoryPoint &out) {
+            bool found = false;
+            portENTER_CRITICAL(&this->__mux__);
+            uint32_t head = this->__head__[res];
+            uint32_t tail = this->__tail__(res, head);
+            if (cursor < tail) cursor = tail;
+            if (cursor < head) {
+                if (res == HISTORY_RAW) {
+                    const RawEntry &e = this->__raw__[cursor % HISTORY_RAW_LEN];
+                    out.time = e.time;
+                    out.min = out.max = out.avg = decode(metric, e.value[metric]);
+                } else {
+                    const RollupEntry &e = res == HISTORY_MINUTE
+                        ? this->__minutes__[cursor % HISTORY_MINUTE_LEN]
+                        : this->__hours__[cursor % HISTORY_HOUR_LEN];
+                    out.time = e.time;
+                    out.min = decode(metric, e.min[metric]);
+                    out.max = decode(metric, e.max[metric]);
+                    out.avg = decode(metric, e.avg[metric]);
+                }
+                cursor++;
+                found = true;
+            }
+            portEXIT_CRITICAL(&this->__mux__);
+            return found;
+        }
+
+        /**
+         * @brief RAM used by the rings and buckets.
+         * @return `size_t` Bytes.
+         */
+        static constexpr size_t footprint() { return sizeof(SensorHistory); }
+
+        /**
+         * @brief Scale a value to the stored int16 representation (also used by SeriesStore).
+         * @param metric The metric, selects the scale.
+         * @param value The value.
+         * @return `int16_t` The scaled, rounded and clamped value.
+         */
+        static int16_t encode(HistoryMetric metric, float value) {
+            float v = value * SCALE[metric];
+            if (v > INT16_MAX) return INT16_MAX;
+            if (v < INT16_MIN) return INT16_MIN;
+            return (int16_t)(v < 0 ? v - 0.5f : v + 0.5f);
+        }
+
+        /**
+         * @brief Inverse of encode().
+         * @param metric The metric, selects the scale.
+         * @param value The stored value.
+         * @return `float` The value.
+         */
+        static float decode(HistoryMetric metric, int16_t value) {
+            return value / SCALE[metric];
+        }
+
+    private:
+        static constexpr float SCALE[HISTORY_METRIC_COUNT] = { 100.0f, 10.0f, 100.0f };
+
+        struct RawEntry {
+            uint32_t time;
+            int16_t value[HISTORY_METRIC_COUNT];
+        };
+
+        struct RollupEntry {
+            uint32_t time;
+            int16_t min[HISTORY_METRIC_COUNT];
+            int16_t max[HISTORY_METRIC_COUNT];
+            int16_t avg[HISTORY_METRIC_COUNT];
+        };
+
+        // Running min/max/sum of the bucket being filled
+        struct Bucket {
+            uint32_t time = 0;
+            uint32_t count = 0;
+            int16_t min[HISTORY_METRIC_COUNT] = {};
+            int16_t max[HISTORY_METRIC_COUNT] = {};
+            int32_t sum[HISTORY_METRIC_COUNT] = {};
+
+            void add(uint32_t start, const int16_t *values) {
+                if (count == 0) {
+                    time = start;
+                    for (uint8_t m = 0; m < HISTORY_METRIC_COUNT; m++) min[m] = max[m] = values[m];
+                }
+                for (uint8_t m = 0; m < HISTORY_METRIC_COUNT; m++) {
+                    if (values[m] < min[m]) min[m] = values[m];
+                    if (values[m] > max[m]) max[m] = values[m];
+                    sum[m] += values[m];
+                }
+                count++;
+            }
+
+            RollupEntry entry() const {
+                RollupEntry e = { time, {}, {}, {} };
+                for (uint8_t m = 0; m < HISTORY_METRIC_COUNT; m++) {
+                    e.min[m] = min[m];
+                    e.max[m] = max[m];
+                    e.avg[m] = (int16_t)(sum[m] / (int32_t)count);
+                }
+                return e;
+            }
+        };
+
+        static constexpr uint32_t __length__(HistoryRes res) {
+            return res == HISTORY_RAW ? HISTORY_RAW_LEN : res == HISTORY_MINUTE ? HISTORY_MINUTE_LEN : HISTORY_HOUR_LEN;
+        }
+
+        // Oldest absolute index still in the ring
+        uint32_t __tail__(HistoryRes res, uint32_t head) const {
+            uint32_t tail = head > __length__(res) ? head - __length__(res) : 0;
+            return tail > this->__first__[res] ? tail : this->__first__[res];
+        }
+
+        // Forget every entry and the open buckets; cursors stay valid and skip ahead
+        void __restart__() {
+            portENTER_CRITICAL(&this->__mux__);
+            memcpy(this->__first__, this->__head__, sizeof(this->__first__));
+            portEXIT_CRITICAL(&this->__mux__);
+            this->__minute__ = Bucket{};
+            this->__hour__ = Bucket{};
+        }
+
+        uint32_t __timeAt__(HistoryRes res, uint32_t index) const {
+            if (res == HISTORY_RAW) return this->__raw__[index % HISTORY_RAW_LEN].time;
+            if (res == HISTORY_MINUTE) return this->__minutes__[index % HISTORY_MINUTE_LEN].time;
+            return this->__hours__[index % HISTORY_HOUR_LEN].time;
+        }
+
+        RawEntry __raw__[HISTORY_RAW_LEN] = {};             ///< Raw samples
+        RollupEntry __minutes__[HISTORY_MINUTE_LEN] = {};   ///< 1-minute rollups
+        RollupEntry __hours__[HISTORY_HOUR_LEN] = {};       ///< 1-hour rollups
+        uint32_t __head__[HISTORY_RES_COUNT] = {};          ///< Entries written per ring
+        uint32_t __first__[HISTORY_RES_COUNT] = {};         ///< First index after the last restart
+        uint32_t __last__ = 0;                              ///< Time of the last sample added
+        Bucket __minute__;                                  ///< Minute being filled
+        Bucket __hour__;                                    ///< Hour being filled
+        portMUX_TYPE __mux__ = portMUX_INITIALIZER_UNLOCKED; ///< Guards the rings and heads
+};
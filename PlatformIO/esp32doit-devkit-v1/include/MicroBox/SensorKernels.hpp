@@ -0,0 +1,164 @@
+/**
+ *  @file SensorKernels.hpp
+ *  @version 1.0.0
+ *  @brief Compile-time calibrated fixed-point conversion kernels for the analog sensors.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * The kernels below turn a raw ADC count into a scaled integer (milli-units).
+ * All calibration constants from `config.h` are folded into integer
+ * coefficients at compile time, so the run-time path is a few integer
+ * multiply/add operations with no float math and no `pow()`. The run-time
+ * path uses fixed-width integer types only. The folding itself is done in
+ * `double`, so results are bit-identical wherever `double` is 64-bit (ESP32,
+ * ESP8266, the native tests); on AVR `double` is 32-bit and a coefficient
+ * can differ in its last bits.
+ */
+
+/**
+ * @brief Round a calibration value to the nearest integer at compile time.
+ * @param value The value to round (half away from zero).
+ */
+constexpr int64_t fixedRound(double value) {
+    return (int64_t)(value < 0 ? value - 0.5 : value + 0.5);
+}
+
+/**
+ * @brief Convert a calibration value to fixed point with `Q` fraction bits.
+ * @param value The value to convert.
+ * @param Q Number of fraction bits.
+ */
+constexpr int64_t toFixed(double value, uint8_t Q) {
+    return fixedRound(value * (double)((int64_t)1 << Q));
+}
+
+/**
+ * @brief Drop `Q` fraction bits, rounding half away from zero.
+ * @details Written without right-shifting negative values so the result
+ *          does not depend on implementation-defined behaviour.
+ */
+template <uint8_t Q, typename T>
+constexpr T fromFixed(T value) {
+    return (value >= 0)
+        ? (T)((value + ((T)1 << (Q - 1))) >> Q)
+        : (T)-((-value + ((T)1 << (Q - 1))) >> Q);
+}
+
+/**
+ * @struct LinearKernel
+ * @brief y = (C0 + C1 * x) / 2^Q, evaluated in 32-bit integers.
+ * @tparam C0 Offset in Q format.
+ * @tparam C1 Slope in Q format.
+ * @tparam Q Number of fraction bits.
+ * @tparam X_MAX Largest input value, used to prove the math cannot overflow.
+ */
+template <int64_t C0, int64_t C1, uint8_t Q, uint16_t X_MAX>
+struct LinearKernel {
+    static_assert(C0 > INT32_MIN && C0 < INT32_MAX, "LinearKernel: offset does not fit in 32 bits, lower Q");
+    static_assert(C1 * X_MAX > INT32_MIN && C1 * X_MAX < INT32_MAX, "LinearKernel: slope does not fit in 32 bits, lower Q");
+    static_assert(C0 + C1 * X_MAX > INT32_MIN && C0 + C1 * X_MAX < INT32_MAX, "LinearKernel: result does not fit in 32 bits, lower Q");
+
+    static constexpr int32_t apply(uint16_t x) {
+        return fromFixed<Q>((int32_t)C0 + (int32_t)C1 * (int32_t)x);
+    }
+};
+
+/**
+ * @struct QuadraticKernel
+ * @brief y = (A2 * x^2 + A1 * x + A0) / 2^Q in Horner form, 64-bit accumulator.
+ * @tparam A2 Quadratic coefficient in Q format.
+ * @tparam A1 Linear coefficient in Q format.
+ * @tparam A0 Constant term in Q format.
+ * @tparam Q Number of fraction bits.
+ * @tparam X_MAX Largest input value, used to prove the math cannot overflow.
+ */
+template <int64_t A2, int64_t A1, int64_t A0, uint8_t Q, uint16_t X_MAX>
+struct QuadraticKernel {
+    // |A2| X^2 + |A1| X + |A0| plus the rounding term bounds every Horner step
+    static constexpr int64_t magnitude(int64_t value) { return value < 0 ? -value : value; }
+    static constexpr int64_t LIMIT = INT64_MAX - ((int64_t)1 << (Q - 1));
+    static constexpr int64_t X = X_MAX > 0 ? X_MAX : 1;
+    static_assert(magnitude(A2) <= LIMIT / X / X, "QuadraticKernel: quadratic term does not fit in 64 bits, lower Q");
+    static_assert(magnitude(A1) <= (LIMIT - magnitude(A2) * X * X) / X, "QuadraticKernel: linear term does not fit in 64 bits, lower Q");
+    static_assert(magnitude(A0) <= LIMIT - magnitude(A2) * X * X - magnitude(A1) * X, "QuadraticKernel: result does not fit in 64 bits, lower Q");
+
+    static constexpr int32_t apply(uint16_t x) {
+        return (int32_t)fromFixed<Q>((A2 * (int64_t)x + A1) * (int64_t)x + A0);
+    }
+};
+
+/**
+ * @brief Clamp a kernel result to a range.
+ */
+constexpr int32_t clampKernel(int32_t value, int32_t low, int32_t high) {
+    return (value < low) ? low : (value > high) ? high : value;
+}
+
+// Largest raw ADC count on this platform
+constexpr uint16_t ADC_FULL_SCALE = (uint16_t)ADC_RESOLUTION;
+
+// Volts per ADC count
+constexpr double ADC_VOLT_PER_COUNT = VOLTAGE_REF / ADC_RESOLUTION;
+
+/**
+ * ADC count -> millivolts.
+ */
+typedef LinearKernel<
+    0,
+    toFixed(1000.0 * ADC_VOLT_PER_COUNT, 16),
+    16, ADC_FULL_SCALE
+> AdcToMillivolt;
+
+/**
+ * ADC count -> milli-pH.
+ * pH = 7 + (PH7 - V) / ((PH4 - PH7) / 3), expanded to C0 + C1 * adc.
+ */
+typedef LinearKernel<
+    toFixed(1000.0 * (7.0 + 3.0 * PH7 / (PH4 - PH7)), 14),
+    toFixed(-1000.0 * 3.0 * ADC_VOLT_PER_COUNT / (PH4 - PH7), 14),
+    14, ADC_FULL_SCALE
+> AdcToMilliPH;
+
+/**
+ * ADC count -> milli-NTU, linear two-point calibration.
+ * NTU = NTU_CLEAN + (adc - ADC_CLEAN) * (NTU_DIRTY - NTU_CLEAN) / (ADC_DIRTY - ADC_CLEAN)
+ */
+typedef LinearKernel<
+    toFixed(1000.0 * (NTU_CLEAN_WATER - (double)ADC_CLEAN_WATER * (NTU_DIRTY_WATER - NTU_CLEAN_WATER) / (ADC_DIRTY_WATER - ADC_CLEAN_WATER)), 8),
+    toFixed(1000.0 * (NTU_DIRTY_WATER - NTU_CLEAN_WATER) / (double)(ADC_DIRTY_WATER - ADC_CLEAN_WATER), 8),
+    8, ADC_FULL_SCALE
+> AdcToMilliNTULinear;
+
+/**
+ * ADC count -> milli-NTU, polynomial calibration.
+ * NTU = a V^2 + b V - c with V = adc * VREF / ADC_RES, expanded in adc.
+ */
+typedef QuadraticKernel<
+    toFixed(1000.0 * NTU_POLY_A * ADC_VOLT_PER_COUNT * ADC_VOLT_PER_COUNT, 32),
+    toFixed(1000.0 * NTU_POLY_B * ADC_VOLT_PER_COUNT, 32),
+    toFixed(-1000.0 * NTU_POLY_C, 32),
+    32, ADC_FULL_SCALE
+> AdcToMilliNTUPolynomial;
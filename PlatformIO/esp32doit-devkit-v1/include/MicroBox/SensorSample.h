@@ -0,0 +1,46 @@
+/**
+ *  @file SensorSample.h
+ *  @version 1.0.0
+ *  @brief One sampling cycle of every sensor.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @struct SensorSample
+ * @brief One sampling cycle of every sensor, published as a unit.
+ * 
+ * Plain data without any Arduino dependency, so the code that formats it
+ * (TelemetryFrame, WebHandlers) also builds in the native test environment.
+ */
+struct SensorSample {
+    float ph;           ///< pH value
+    float ph_voltage;   ///< pH probe voltage (V)
+    float ntu;          ///< Water turbidity (NTU)
+    uint16_t ntu_adc;   ///< Turbidity raw ADC value
+    float distance;     ///< Ultrasonic distance (cm)
+    float capacity;     ///< Feed capacity (%)
+    uint32_t timestamp; ///< `millis()` when the cycle finished
+    uint32_t sequence;  ///< Publication number, 0 if nothing was published yet
+};
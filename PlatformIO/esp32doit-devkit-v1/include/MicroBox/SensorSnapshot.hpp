@@ -0,0 +1,91 @@
+/**
+ *  @file SensorSnapshot.hpp
+ *  @version 1.0.0
+ *  @brief Lock-free (seqlock) snapshot of one complete sensor sample set.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "SensorSample.h"
+
+/**
+ * @class SensorSnapshot
+ * @brief Single-writer, multi-reader sequence lock around a SensorSample.
+ * 
+ * The writer bumps the sequence to an odd value, copies the sample and bumps
+ * it to the next even value. A reader copies the sample between two loads of
+ * the sequence and retries if they differ or are odd, so it always gets one
+ * consistent sampling cycle without taking a mutex. The writer runs the copy
+ * with preemption off on its own core, so a reader never waits on a writer
+ * that has been switched out.
+ */
+class SensorSnapshot {
+    public:
+        /**
+         * @brief Publish a new sample set. Only one task may call this.
+         * @param sample The sample set to publish; `sequence` is filled in.
+         */
+        void publish(const SensorSample &sample) {
+            portENTER_CRITICAL(&this->__mux__);
+            uint32_t seq = this->__seq__.load(std::memory_order_relaxed);
+            this->__seq__.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            this->__data__ = sample;
+            this->__data__.sequence = (seq / 2) + 1;
+
+            this->__seq__.store(seq + 2, std::memory_order_release);
+            portEXIT_CRITICAL(&this->__mux__);
+        }
+
+        /**
+         * @brief Copy the latest consistent sample set.
+         * @param sample Receives the copy.
+         * @return `false` if nothing has been published yet.
+         */
+        bool read(SensorSample &sample) const {
+            uint32_t before, after;
+            do {
+                before = this->__seq__.load(std::memory_order_acquire);
+                if (before & 1) continue; // Writer in progress
+
+                sample = this->__data__;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = this->__seq__.load(std::memory_order_relaxed);
+            } while ((before & 1) || before != after);
+
+            return before != 0;
+        }
+
+        /**
+         * @brief Number of sample sets published since boot.
+         */
+        uint32_t sequence() const {
+            return this->__seq__.load(std::memory_order_acquire) / 2;
+        }
+
+    private:
+        std::atomic<uint32_t> __seq__{0};           ///< Even: stable, odd: write in progress
+        SensorSample __data__ = {};                 ///< Latest sample set
+        portMUX_TYPE __mux__ = portMUX_INITIALIZER_UNLOCKED; ///< Writer-side preemption guard
+};
@@ -0,0 +1,174 @@
+/**
+ *  @file SeriesStore.h
+ *  @version 1.0.0
+ *  @brief Append-only sensor time series on LittleFS with segment compaction.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <functional>
+#include "config.h"
+#include "SensorSnapshot.hpp"
+#include "SensorHistory.hpp"
+
+/**
+ * @brief One stored record, 12 bytes little-endian; scales as in SensorHistory.
+ */
+struct SeriesRecord {
+    uint32_t time;      ///< Start of the period, unix seconds (RTC local time)
+    int16_t ph;         ///< pH x 100
+    int16_t ntu;        ///< NTU x 10
+    int16_t capacity;   ///< Capacity % x 100
+    uint16_t samples;   ///< Sensor samples averaged into the record
+};
+
+/**
+ * @class SeriesStoreClass
+ * @brief Log-structured store of averaged sensor records in rotating segment files.
+ * 
+ * The sensor task averages its samples over SERIES_RECORD_PERIOD_S and
+ * queues one record in RAM. A low-priority task appends the queued records
+ * to the newest segment (`SERIES_DIR/r<seq>.bin`) once SERIES_BATCH_RECORDS
+ * are waiting or SERIES_SYNC_INTERVAL_MS has passed, and closes the file
+ * so LittleFS commits it. Each segment holds SERIES_SEGMENT_RECORDS
+ * records after an 8-byte header. Beyond SERIES_RAW_SEGMENTS the oldest raw
+ * segment is compacted: every SERIES_COMPACT_FACTOR records are averaged
+ * into one and appended to `SERIES_DIR/c<seq>.bin`, then the raw file is
+ * removed; beyond SERIES_COMPACT_SEGMENTS the oldest compacted file goes.
+ * 
+ * At boot the segment index (sequence, first/last time, count) is rebuilt
+ * from the directory listing, the file sizes and two record reads per file.
+ */
+class SeriesStoreClass {
+    public:
+        /**
+         * @brief Mount LittleFS, rebuild the segment index and start the writer task.
+         * Records kept by RetainedLog that are newer than the files are appended first.
+         * @return `false` if the filesystem could not be mounted.
+         */
+        bool begin();
+
+        /**
+         * @brief Add one sensor sample. Only the sensor task may call this.
+         * @param sample The published sample set.
+         * @param unixtime RTC time of the sample, unix seconds.
+         */
+        void add(const SensorSample &sample, uint32_t unixtime);
+
+        /**
+         * @brief Read back the stored records, oldest first (compacted, then raw).
+         * Call from setup, before the sensor task starts adding records.
+         * @param from Skip records older than this, unix seconds.
+         * @param callback Called for each record.
+         * @return Number of records passed to the callback.
+         */
+        size_t replay(uint32_t from, const std::function<void(const SeriesRecord &)> &callback);
+
+        uint32_t records() const { return this->__records__; }             ///< Records appended since boot
+        uint32_t dropped() const { return this->__dropped__; }             ///< Records lost to a full RAM queue
+        uint32_t restored() const { return this->__restored__; }           ///< Records recovered from RTC memory at boot
+        uint32_t bytesWritten() const { return this->__bytesWritten__; }   ///< File bytes written, incl. headers and compaction
+        uint32_t rebuildMicros() const { return this->__rebuildMicros__; } ///< Boot index rebuild time (us)
+        uint32_t worstFlushMicros() const { return this->__worstFlush__; } ///< Slowest batch write (us)
+
+        /**
+         * @brief Write amplification at file level: bytes written per record byte appended.
+         * @return `float` 1.0 means every byte was written once.
+         */
+        float writeAmplification() const {
+            uint32_t payload = this->__records__ * sizeof(SeriesRecord);
+            return payload ? (float)this->__bytesWritten__ / payload : 0.0f;
+        }
+
+    private:
+        /**
+         * @brief Segment file header.
+         */
+        struct SegmentHeader {
+            char magic[4];      ///< "MBTS"
+            uint8_t version;    ///< Layout version, 1
+            uint8_t compacted;  ///< 1 if records are SERIES_COMPACT_FACTOR averages
+            uint16_t recordSize;///< sizeof(SeriesRecord)
+        };
+
+        /**
+         * @brief Index entry of one segment file.
+         */
+        struct Segment {
+            uint32_t seq;       ///< Sequence number from the file name
+            uint32_t first;     ///< Time of the first record
+            uint32_t last;      ///< Time of the last record
+            uint16_t count;     ///< Records in the file
+        };
+
+        /**
+         * @brief Segment index of one kind (raw or compacted), oldest first.
+         */
+        struct SegmentList {
+            Segment items[(SERIES_RAW_SEGMENTS > SERIES_COMPACT_SEGMENTS ? SERIES_RAW_SEGMENTS : SERIES_COMPACT_SEGMENTS) + 1];
+            uint8_t size;       ///< Entries in use
+            uint8_t limit;      ///< Segments kept before the oldest is compacted or removed
+            bool compacted;     ///< Kind of the segments
+        };
+
+        static void __task__(void *pvParameter);
+        void __run__();
+        void __flush__();
+        size_t __append__(SegmentList &list, const SeriesRecord *records, size_t count);
+        bool __compact__();
+        void __dropOldest__(SegmentList &list);
+        uint32_t __lastTime__() const;
+        void __indexFile__(File &file);
+        static void __path__(char (&path)[24], bool compacted, uint32_t seq);
+
+        // Running average of the current period
+        uint32_t __periodStart__ = 0;
+        uint16_t __periodCount__ = 0;
+        int32_t __periodSum__[HISTORY_METRIC_COUNT] = {};
+
+        // Records waiting for the writer task
+        SeriesRecord __queue__[SERIES_BATCH_RECORDS * 2];
+        uint16_t __queueLen__ = 0;
+        portMUX_TYPE __mux__ = portMUX_INITIALIZER_UNLOCKED; ///< Guards `__queue__`
+        TaskHandle_t __taskHandle__ = NULL;
+
+        SegmentList __raw__ = { {}, 0, SERIES_RAW_SEGMENTS, false };
+        SegmentList __compacted__ = { {}, 0, SERIES_COMPACT_SEGMENTS, true };
+        uint32_t __nextSeq__ = 1;
+        uint32_t __compactSeq__ = 0;        ///< Raw segment of the last compaction pass
+        uint32_t __compactDone__ = 0;       ///< Its records already in a compacted segment
+        char __stale__[4][24];              ///< Files to remove after the boot scan
+        uint8_t __staleCount__ = 0;
+
+        volatile uint32_t __records__ = 0;
+        volatile uint32_t __dropped__ = 0;
+        volatile uint32_t __bytesWritten__ = 0;
+        uint32_t __restored__ = 0;
+        uint32_t __rebuildMicros__ = 0;
+        uint32_t __worstFlush__ = 0;
+};
+
+#if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_SeriesStore)
+extern SeriesStoreClass SeriesStore;
+#endif
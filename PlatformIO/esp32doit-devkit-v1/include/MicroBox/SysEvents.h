@@ -0,0 +1,129 @@
+/**
+ *  @file SysEvents.h
+ *  @version 1.0.0
+ *  @brief Event group and wakeup accounting shared by the FreeRTOS tasks.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+// System event bits
+#define SYS_EVT_SENSOR_READY    BIT0    ///< vTask1 published a sample that switches the relay or may start a held feed
+#define SYS_EVT_SCHEDULE_DUE    BIT1    ///< A feeding schedule entry is due
+#define SYS_EVT_FEED_REQUEST    BIT2    ///< Manual feed was requested (Blynk)
+#define SYS_EVT_BUTTON          BIT3    ///< Boot button changed state
+#define SYS_EVT_NETWORK         BIT4    ///< Wi-Fi connected, disconnected or got an IP
+#define SYS_EVT_REBOOT          BIT5    ///< A reboot was requested
+#define SYS_EVT_ALL             (SYS_EVT_SENSOR_READY | SYS_EVT_SCHEDULE_DUE | SYS_EVT_FEED_REQUEST | \
+                                 SYS_EVT_BUTTON | SYS_EVT_NETWORK | SYS_EVT_REBOOT)
+
+/**
+ * @brief Identifiers of the application tasks, used for wakeup accounting.
+ */
+enum SysTask : uint8_t {
+    SYS_TASK_SENSOR,    ///< vTask1
+    SYS_TASK_NETWORK,   ///< vTask2
+    SYS_TASK_SYSTEM,    ///< vTask3
+    SYS_TASK_COUNT
+};
+
+/**
+ * @class SysEvents
+ * @brief Static wrapper around one FreeRTOS event group.
+ * 
+ * Producers (ISRs, Wi-Fi callbacks, web and Blynk handlers) set event bits
+ * and the task that owns the work blocks on them instead of polling on a
+ * fixed period. Each task also counts its own wakeups so the idle cost of
+ * the scheduling can be compared in the periodic system report.
+ */
+class SysEvents {
+    public:
+        /**
+         * @brief Create the event group. Must run before the tasks start.
+         */
+        static void begin() {
+            if (instance().__group__ == NULL) instance().__group__ = xEventGroupCreate();
+        }
+
+        /**
+         * @brief Set event bits from task context.
+         * @param bits Bits to set.
+         */
+        static void set(EventBits_t bits) {
+            if (instance().__group__ != NULL) xEventGroupSetBits(instance().__group__, bits);
+        }
+
+        /**
+         * @brief Set event bits from an interrupt handler.
+         * @param bits Bits to set.
+         */
+        static void IRAM_ATTR setFromISR(EventBits_t bits) {
+            BaseType_t woken = pdFALSE;
+            if (instance().__group__ != NULL && xEventGroupSetBitsFromISR(instance().__group__, bits, &woken) == pdPASS) {
+                if (woken) portYIELD_FROM_ISR();
+            }
+        }
+
+        /**
+         * @brief Block until any of the bits is set or the timeout expires.
+         * @param bits Bits to wait for; the returned bits are cleared.
+         * @param timeout Maximum time to block, in ticks.
+         * @return The bits that were set (0 on timeout).
+         */
+        static EventBits_t wait(EventBits_t bits, TickType_t timeout) {
+            if (instance().__group__ == NULL) {
+                vTaskDelay(timeout);
+                return 0;
+            }
+            return xEventGroupWaitBits(instance().__group__, bits, pdTRUE, pdFALSE, timeout) & bits;
+        }
+
+        /**
+         * @brief Count one wakeup of a task.
+         * @param task The task that woke up.
+         */
+        static void wakeup(SysTask task) {
+            instance().__wakeups__[task]++;
+        }
+
+        /**
+         * @brief Read and reset the wakeup counter of a task.
+         * @param task The task to query.
+         * @return Wakeups since the previous call.
+         */
+        static uint32_t takeWakeups(SysTask task) {
+            uint32_t count = instance().__wakeups__[task];
+            instance().__wakeups__[task] = 0;
+            return count;
+        }
+
+    private:
+        static SysEvents &instance() {
+            static SysEvents instance;
+            return instance;
+        }
+
+        EventGroupHandle_t __group__ = NULL;                ///< Shared event group
+        volatile uint32_t __wakeups__[SYS_TASK_COUNT] = {}; ///< Wakeups per task
+};
@@ -10,7 +10,9 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include "LEDBoard.h"
-#include "MyEEPROM.hpp"
+#include "ConfigStore.hpp"
+#include "RetainedLog.h"
+#include "Logger.h"
 #include "externprog.h"
 
 class RebootSys {
@@ -33,18 +35,19 @@ class RebootSys {
 
             if (state) {
                 if (!_message_Printed) {
-                    Serial.println(F("\n\nReboot Sysytem... Please wait\n"));
+                    LOG_WARN("sys", "Reboot system... please wait");
                     _message_Printed = true;
                 }
 
                 unsigned long _elapsed = millis() - *LastTime;
                 if (_elapsed <= 3000 && millis() - _previous_Millis >= 1000) {
                     _previous_Millis = millis();
-                    Serial.println(_count_down--);
+                    LOG_INFO("sys", "Reboot in %d", _count_down--);
                 }
 
                 else if (_elapsed > 6000 && _elapsed <= 9000 && _count_down <= 0)
                 {
+                    ConfigStore::flush();
                     ESP.restart();
                 }
             }
@@ -72,7 +75,7 @@ class AutoChangeState {
     private:
         void __run(uint32_t TIMEOUT) {
             if (TIMEOUT <= 1) {
-                Serial.println(F("Timeout must be greater that 1 minute."));
+                LOG_ERROR("wifi", "Timeout must be greater than 1 minute");
                 return;
             }
 
@@ -106,10 +109,11 @@ class AutoChangeState {
 
                 if (elapsed >= this->timeout) {
                     // Execute action after timeout
-                    Serial.println(F("Wi-Fi disconnected for 30 minutes. Saving state and resetting ESP."));
-                    this->eeprom.save_wifi_state(false);
+                    LOG_WARN("wifi", "Wi-Fi disconnected for %lu minutes. Saving state and resetting ESP.", this->timeout / 60000UL);
+                    ConfigStore::setWifiMode(false);
+                    ConfigStore::flush();
                     delay(1000);
-                    ESP.restart(); // Perform restart
+                    RetainedLog::restart(REBOOT_WIFI_OFFLINE); // Perform restart
                 }
                 else {
                     // Calculate remaining time and convert to minutes and seconds
@@ -130,21 +134,11 @@ class AutoChangeState {
                 lastPrintTime = millis();
 
                 // Print remaining time in MM:SS format
-                Serial.print(F("Wi-Fi disconnected. Remaining time: "));
-                if (minutes < 10) {
-                    Serial.print(F("0"));
-                }
-                Serial.print(minutes);
-                Serial.print(F(":"));
-                if (seconds < 10) {
-                    Serial.print(F("0"));
-                }
-                Serial.println(seconds);
+                LOG_INFO("wifi", "Wi-Fi disconnected. Remaining time: %02lu:%02lu", minutes, seconds);
             }
         }
 
     private:
-        MyEEPROM eeprom;                      ///< Instance of MyEEPROM for EEPROM operations
         bool autoChangeEnabled = true;       ///< Flag indicating whether autoChange is enabled
         unsigned long timeout = 0;            ///< Timeout value in milliseconds
         unsigned long startMillis = millis(); ///< Start time of Wi-Fi disconnection
@@ -0,0 +1,120 @@
+/**
+ *  @file TelemetryFrame.hpp
+ *  @version 1.0.0
+ *  @brief Versioned fixed-layout binary telemetry frame (little-endian).
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "SensorSample.h"
+
+#define TELEMETRY_FRAME_VERSION 1           ///< Bump when the layout changes
+#define TELEMETRY_FRAME_SIZE    32          ///< Encoded size in bytes
+#define TELEMETRY_TOPIC_HTTP    0xFF        ///< Topic byte of frames sent over HTTP
+#define TELEMETRY_MIME          "application/vnd.microbox.telemetry" ///< HTTP content type / Accept value
+
+/**
+ * @class TelemetryFrame
+ * @brief Encodes one telemetry snapshot into a fixed 32-byte frame.
+ * 
+ * Layout (all fields little-endian, scaled integers instead of floats):
+ * 
+ *  | Offset | Type   | Field                              |
+ *  |--------|--------|------------------------------------|
+ *  | 0      | char[2]| magic "MB"                         |
+ *  | 2      | uint8  | version (TELEMETRY_FRAME_VERSION)  |
+ *  | 3      | uint8  | topic: WSTopic, 0xFF over HTTP     |
+ *  | 4      | uint32 | sensor sequence                    |
+ *  | 8      | uint32 | sensor timestamp, millis()         |
+ *  | 12     | uint32 | RTC time, unix seconds (local)     |
+ *  | 16     | uint16 | total heap, KB x 100               |
+ *  | 18     | uint16 | free heap, KB x 100                |
+ *  | 20     | uint16 | pH x 1000                          |
+ *  | 22     | int32  | turbidity, NTU x 100               |
+ *  | 26     | int16  | capacity, % x 100                  |
+ *  | 28     | uint16 | distance, cm x 10                  |
+ *  | 30     | uint16 | reserved, 0                        |
+ * 
+ * The decoder in data/WEB/js/telemetry.js mirrors this table.
+ */
+class TelemetryFrame {
+    public:
+        /**
+         * @brief Encode a frame.
+         * @param out Destination, at least TELEMETRY_FRAME_SIZE bytes.
+         * @param topic Topic id stored in the header.
+         * @param sample Sensor sample set.
+         * @param unixtime RTC time in unix seconds.
+         * @param totalHeap Total heap in KB.
+         * @param freeHeap Free heap in KB.
+         * @return `size_t` Number of bytes written (TELEMETRY_FRAME_SIZE).
+         */
+        static size_t encode(
+            uint8_t *out, uint8_t topic, const SensorSample &sample, uint32_t unixtime,
+            float totalHeap, float freeHeap
+        ) {
+            out[0] = 'M';
+            out[1] = 'B';
+            out[2] = TELEMETRY_FRAME_VERSION;
+            out[3] = topic;
+            put32(out + 4, sample.sequence);
+            put32(out + 8, sample.timestamp);
+            put32(out + 12, unixtime);
+            put16(out + 16, scale(totalHeap, 100, 0, UINT16_MAX));
+            put16(out + 18, scale(freeHeap, 100, 0, UINT16_MAX));
+            put16(out + 20, scale(sample.ph, 1000, 0, UINT16_MAX));
+            put32(out + 22, (uint32_t)scale(sample.ntu, 100, INT32_MIN, INT32_MAX));
+            put16(out + 26, (uint16_t)scale(sample.capacity, 100, INT16_MIN, INT16_MAX));
+            put16(out + 28, scale(sample.distance, 10, 0, UINT16_MAX));
+            put16(out + 30, 0);
+            return TELEMETRY_FRAME_SIZE;
+        }
+
+    private:
+        // Round to the nearest integer step and clamp into the field range.
+        // The clamp runs on the float: casting NaN or an out-of-range value
+        // to an integer is undefined. NaN (a failed reading) encodes as 0.
+        static int32_t scale(float value, float factor, int64_t low, int64_t high) {
+            float scaled = value * factor;
+            if (isnan(scaled)) return 0;
+            if (scaled <= (float)low) return (int32_t)low;
+            if (scaled >= (float)high) return (int32_t)high;
+
+            int64_t v = (int64_t)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+            return (int32_t)(v < low ? low : v > high ? high : v);
+        }
+
+        static void put16(uint8_t *p, uint16_t v) {
+            p[0] = v & 0xFF;
+            p[1] = v >> 8;
+        }
+
+        static void put32(uint8_t *p, uint32_t v) {
+            p[0] = v & 0xFF;
+            p[1] = (v >> 8) & 0xFF;
+            p[2] = (v >> 16) & 0xFF;
+            p[3] = v >> 24;
+        }
+};
@@ -0,0 +1,169 @@
+/**
+ *  @file TemplateRenderer.hpp
+ *  @version 1.0.0
+ *  @brief Streams an HTML page and substitutes its %TOKEN% placeholders.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <functional>
+#include <string_view>
+#include "config.h"
+
+/**
+ * @class TemplateRenderer
+ * @brief Pull-based `%TOKEN%` substitution over a page of any size.
+ * 
+ * The page is read TEMPLATE_READ_LEN bytes at a time and written out in
+ * whatever chunk sizes the transport asks for, so neither the page nor the
+ * rendered result is ever held in RAM. A placeholder may straddle two reads
+ * or two chunks. `%%` is sent as `%`, and a `%` that does not start a
+ * placeholder (e.g. `width: 100%;`) is sent unchanged. Unknown placeholders
+ * stay visible in the page.
+ */
+class TemplateRenderer {
+    public:
+        /**
+         * @brief Reads the next part of the page; returns the bytes read, 0 at the end.
+         */
+        using Reader = std::function<size_t(uint8_t *buf, size_t len)>;
+
+        explicit TemplateRenderer(Reader reader) : __reader__(reader) {}
+        virtual ~TemplateRenderer() {}
+
+        /**
+         * @brief Write the next part of the rendered page.
+         * @param out Destination.
+         * @param maxLen Size of `out`.
+         * @return `size_t` Bytes written; 0 once the whole page has been sent.
+         */
+        size_t fill(uint8_t *out, size_t maxLen) {
+            size_t n = 0;
+            while (n < maxLen) {
+                // Finish the value (or literal text) of the last placeholder first
+                if (this->__pendingPos__ < this->__pendingLen__) {
+                    size_t k = this->__pendingLen__ - this->__pendingPos__;
+                    if (k > maxLen - n) k = maxLen - n;
+                    memcpy(out + n, this->__pending__ + this->__pendingPos__, k);
+                    this->__pendingPos__ += k;
+                    n += k;
+                    continue;
+                }
+
+                int c = this->__next__();
+                if (c < 0) {
+                    // Page ended inside a `%...`, send what was collected as text
+                    if (this->__inToken__) this->__literal__(-1);
+                    if (this->__pendingPos__ < this->__pendingLen__) continue;
+                    break;
+                }
+
+                if (!this->__inToken__) {
+                    if (c == '%') {
+                        this->__inToken__ = true;
+                        this->__tokenLen__ = 0;
+                    }
+                    else out[n++] = (uint8_t)c;
+                }
+                else if (c == '%') {
+                    if (this->__tokenLen__ == 0) out[n++] = '%';
+                    else this->__resolve__();
+                    this->__inToken__ = false;
+                }
+                else if (isTokenChar(c) && this->__tokenLen__ < TEMPLATE_TOKEN_LEN) {
+                    this->__token__[this->__tokenLen__++] = (char)c;
+                }
+                else this->__literal__(c);
+            }
+            return n;
+        }
+
+    protected:
+        /**
+         * @brief Value of one placeholder.
+         * @param name Placeholder name without the `%` delimiters.
+         * @return The value, or `nullptr` to keep the placeholder as is.
+         */
+        virtual const char *__lookup__(std::string_view name) = 0;
+
+    private:
+        static bool isTokenChar(int c) {
+            return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+        }
+
+        // Next page byte, -1 at the end
+        int __next__() {
+            if (this->__inPos__ == this->__inLen__) {
+                if (this->__eof__) return -1;
+                this->__inLen__ = this->__reader__(this->__in__, sizeof(this->__in__));
+                this->__inPos__ = 0;
+                if (this->__inLen__ == 0) {
+                    this->__eof__ = true;
+                    return -1;
+                }
+            }
+            return this->__in__[this->__inPos__++];
+        }
+
+        // Queue the value of the collected placeholder, or the placeholder itself if unknown
+        void __resolve__() {
+            const char *value = this->__lookup__(std::string_view(this->__token__, this->__tokenLen__));
+            if (value == nullptr) {
+                this->__literal__('%');
+                return;
+            }
+
+            // Copied, the value may change while the page is still streaming
+            size_t len = strlen(value);
+            if (len > TEMPLATE_VALUE_LEN) len = TEMPLATE_VALUE_LEN;
+            memcpy(this->__pending__, value, len);
+            this->__pendingLen__ = len;
+            this->__pendingPos__ = 0;
+        }
+
+        // Queue "%" + the collected name + `last` as plain text; `last` < 0 adds nothing
+        void __literal__(int last) {
+            this->__pending__[0] = '%';
+            memcpy(this->__pending__ + 1, this->__token__, this->__tokenLen__);
+            this->__pendingLen__ = this->__tokenLen__ + 1;
+            if (last >= 0) this->__pending__[this->__pendingLen__++] = (char)last;
+            this->__pendingPos__ = 0;
+            this->__inToken__ = false;
+        }
+
+        Reader __reader__;                          ///< Page source
+        uint8_t __in__[TEMPLATE_READ_LEN];          ///< Page bytes not yet rendered
+        size_t __inLen__ = 0;                       ///< Valid bytes in `__in__`
+        size_t __inPos__ = 0;                       ///< Next byte of `__in__`
+        bool __eof__ = false;                       ///< Reader has returned 0
+
+        char __token__[TEMPLATE_TOKEN_LEN];         ///< Placeholder name collected so far
+        size_t __tokenLen__ = 0;                    ///< Length of `__token__`
+        bool __inToken__ = false;                   ///< Inside `%...`
+
+        char __pending__[(TEMPLATE_VALUE_LEN > TEMPLATE_TOKEN_LEN + 2) ? TEMPLATE_VALUE_LEN : TEMPLATE_TOKEN_LEN + 2]; ///< Output not yet written
+        size_t __pendingLen__ = 0;                  ///< Length of `__pending__`
+        size_t __pendingPos__ = 0;                  ///< Next byte of `__pending__`
+};
@@ -25,50 +25,143 @@
 #pragma once
 
 #include <Arduino.h>
+#include "config.h"
 
 /**
  * @class Ultrasonic
  * @brief Class for handling ultrasonic sensor operations.
+ * 
+ * The echo pulse is timed by a GPIO edge interrupt instead of `pulseIn()`.
+ * `ping()` fires the trigger and returns immediately, `update()` hands the
+ * finished measurement (or a timeout) to the registered callback, so the
+ * calling task never spins waiting for the echo.
  */
 class Ultrasonic {
     public:
+        /**
+         * @brief Callback type used to deliver a measurement.
+         * @param distance The measured distance in centimeters.
+         * @param valid `false` if the echo timed out, `distance` is then the last valid value.
+         */
+        typedef void (*EchoCallback)(float distance, bool valid);
+
         /**
          * @brief Constructor for Ultrasonic class.
          * @param TriggerPin The pin number connected to the trigger pin of the ultrasonic sensor.
          * @param EchoPin The pin number connected to the echo pin of the ultrasonic sensor.
+         * @param Timeout Echo timeout in microseconds, measured from the trigger pulse.
          */
-        Ultrasonic(uint8_t TriggerPin, uint8_t EchoPin) {
+        Ultrasonic(uint8_t TriggerPin, uint8_t EchoPin, uint32_t Timeout = ULTRASONIC_TIMEOUT_US) {
             this->triggerPin = TriggerPin;
             this->echoPin    = EchoPin;
+            this->timeout    = Timeout;
         }
 
         /**
-         * @brief Initializes the ultrasonic sensor pins.
+         * @brief Initializes the ultrasonic sensor pins and the echo interrupt.
          */
         void begin() {
             pinMode(this->triggerPin, OUTPUT);
             pinMode(this->echoPin, INPUT);
+            digitalWrite(this->triggerPin, LOW);
+            attachInterruptArg(digitalPinToInterrupt(this->echoPin), Ultrasonic::__echoISR__, this, CHANGE);
         }
 
         /**
-         * @brief Measures the distance using the ultrasonic sensor.
-         * @return The measured distance in centimeters.
+         * @brief Register the function that receives each measurement.
+         * @param callback Function called from `update()` in task context.
          */
-        float getDistance() {
+        void onEcho(EchoCallback callback) {
+            this->callback = callback;
+        }
+
+        /**
+         * @brief Change the echo timeout.
+         * @param Timeout Echo timeout in microseconds, measured from the trigger pulse.
+         */
+        void setTimeout(uint32_t Timeout) {
+            this->timeout = Timeout;
+        }
+
+        /**
+         * @brief Start a new measurement without waiting for the echo.
+         * @return `false` if a measurement is still pending or the echo line is still high.
+         */
+        bool ping() {
+            if (this->pending || digitalRead(this->echoPin) == HIGH) return false;
+
+            this->echoStart = 0;
+            this->echoDone  = false;
+            this->pending   = true;
+
             // Send a 10 microseconds pulse to trigger the sensor.
-            digitalWrite(this->triggerPin, LOW);
-            delayMicroseconds(5);
             digitalWrite(this->triggerPin, HIGH);
             delayMicroseconds(10);
             digitalWrite(this->triggerPin, LOW);
+            this->pingTime = micros();
+            return true;
+        }
 
-            // Read the echo pin and calculate distance based on the duration of the pulse.
-            this->value = pulseIn(this->echoPin, HIGH) * 0.034 / 2;
+        /**
+         * @brief Deliver a finished measurement to the callback.
+         * @return `true` if a measurement (valid or timed out) was delivered.
+         */
+        bool update() {
+            if (!this->pending) return false;
+
+            bool valid;
+            if (this->echoDone) {
+                // Calculate distance based on the duration of the pulse.
+                uint32_t width = this->echoWidth;
+                valid = width <= this->timeout;
+                if (valid) this->value = width * 0.034 / 2;
+            } else if ((uint32_t)(micros() - this->pingTime) > this->timeout) {
+                valid = false;
+            } else {
+                return false;
+            }
+
+            this->pending = false;
+            if (this->callback != nullptr) this->callback(this->value, valid);
+            return true;
+        }
+
+        /**
+         * @brief Get the last valid distance.
+         * @return The measured distance in centimeters.
+         */
+        float getDistance() {
             return this->value;
         }
 
+    private:
+        /**
+         * @brief Echo pin interrupt, timestamps the rising and falling edges.
+         * @param arg Pointer to the owning Ultrasonic instance.
+         */
+        static void IRAM_ATTR __echoISR__(void *arg) {
+            Ultrasonic *self = static_cast<Ultrasonic *>(arg);
+            uint32_t now = micros();
+
+            if (digitalRead(self->echoPin) == HIGH) {
+                self->echoStart = now;
+            } else if (self->echoStart != 0 && !self->echoDone) {
+                self->echoWidth = now - self->echoStart;
+                self->echoDone  = true;
+            }
+        }
+
     private:
         uint8_t triggerPin; ///< Pin number for the trigger pin.
         uint8_t echoPin;    ///< Pin number for the echo pin.
-        float value;
+        uint32_t timeout;   ///< Echo timeout in microseconds.
+        float value = 0;    ///< Last valid distance in centimeters.
+
+        EchoCallback callback = nullptr; ///< Measurement consumer.
+        bool pending = false;            ///< A ping is waiting for its echo.
+        uint32_t pingTime = 0;           ///< Time the trigger pulse was sent.
+
+        volatile uint32_t echoStart = 0; ///< Rising edge timestamp (ISR).
+        volatile uint32_t echoWidth = 0; ///< Echo pulse width in microseconds (ISR).
+        volatile bool echoDone = false;  ///< Falling edge seen (ISR).
 };
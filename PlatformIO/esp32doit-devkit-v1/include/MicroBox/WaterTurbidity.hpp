@@ -27,6 +27,8 @@
 #pragma once
 #include <Arduino.h>
 #include "config.h"
+#include "ADCSampler.h"
+#include "SensorKernels.hpp"
 
 /**
  * @class WaterTurbidityClass
@@ -34,7 +36,7 @@
  */
 class WaterTurbidityClass {
     public:
-        uint16_t ADC_value;     ///< ADC value read from the turbidity sensor
+        uint16_t ADC_value = 0; ///< ADC value read from the turbidity sensor
         float voltage;          ///< Voltage calculated from the ADC value
         float NTU_value;        ///< Calculated NTU value
 
@@ -49,37 +51,43 @@ class WaterTurbidityClass {
         
         /**
          * @brief Reads the sensor value and calculates the NTU (Nephelometric Turbidity Units).
-         * @param polynomial Optional flag to use polynomial calculation instead of linear regression.
-         * @param a Coefficient for the quadratic term in the polynomial equation.
-         * @param b Coefficient for the linear term in the polynomial equation.
-         * @param c Constant term in the polynomial equation.
+         * @param polynomial Optional flag to use the polynomial curve (`NTU_POLY_*` in config.h)
+         *                   instead of linear regression.
          */
-        void run(bool polynomial = false, long a = -2572.2, long b = 8700.5, const long c = 4352.9) {
+        void run(bool polynomial = false) {
             // Read the ADC value from the sensor.
-            this->ADC_value = analogRead(this->_pinout);
+            this->ADC_value = this->readADC();
 
+            // Calculate the voltage
+            this->voltage = AdcToMillivolt::apply(this->ADC_value) / 1000.0f;
+
+            int32_t milliNTU;
             if (polynomial) {
-                // Calculate the voltage
-                this->voltage   = (ADC_value / ADC_RESOLUTION) * VOLTAGE_REF;
-                // Apply the polynomial equation
-                // NTU formula = -ax^2 + bx - c
-                this->NTU_value = a * pow(voltage, 2) + b * voltage - c;
+                // NTU formula = a*V^2 + b*V - c, evaluated in Horner form
+                milliNTU = AdcToMilliNTUPolynomial::apply(this->ADC_value);
 
                 // Ensure NTU is within the valid range
-                this->NTU_value = (this->NTU_value < 0) ? 0 : this->NTU_value;
+                milliNTU = (milliNTU < 0) ? 0 : milliNTU;
             } else {
                 // Calculate NTU using linear regression
-                this->NTU_value = NTU_CLEAN_WATER +
-                                ((float)(this->ADC_value - ADC_CLEAN_WATER) *
-                                (NTU_DIRTY_WATER - NTU_CLEAN_WATER) /
-                                (ADC_DIRTY_WATER - ADC_CLEAN_WATER));
+                milliNTU = AdcToMilliNTULinear::apply(this->ADC_value);
 
                 // Ensure NTU is within the valid range
-                // this->NTU_value = constrain(this->NTU_value, NTU_CLEAN_WATER, NTU_DIRTY_WATER);
-                this->NTU_value = (this->NTU_value < NTU_CLEAN_WATER) ? NTU_CLEAN_WATER : (this->NTU_value > NTU_DIRTY_WATER) ? NTU_DIRTY_WATER : this->NTU_value;
+                milliNTU = clampKernel(milliNTU, NTU_CLEAN_WATER * 1000, NTU_DIRTY_WATER * 1000);
             }
+            this->NTU_value = milliNTU / 1000.0f;
         }
 
     private:
         uint8_t _pinout;
+
+        /**
+         * @brief Take the oversampled value from the ADC sampler when it runs,
+         *        otherwise fall back to a single blocking conversion.
+         */
+        uint16_t readADC() {
+            uint16_t value;
+            if (ADCSampler.read(this->_pinout, value)) return value;
+            return ADCSampler.running() ? this->ADC_value : analogRead(this->_pinout);
+        }
 };
@@ -0,0 +1,159 @@
+/**
+ *  @file WebExchange.h
+ *  @version 1.0.0
+ *  @brief Thin request/response interface between the web handlers and the HTTP transport.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <functional>
+
+// Define MIME types for HTTP responses
+#define APPJSON   "application/json"
+#define TEXTHTML  "text/html"
+#define TEXTPLAIN "text/plain"
+
+/**
+ * @class JsonSink
+ * @brief Byte sink a response body is serialized into.
+ * 
+ * Has the two `write()` overloads ArduinoJson expects from a custom writer,
+ * so `serializeJson(doc, sink)` works without this header knowing about
+ * ArduinoJson.
+ */
+class JsonSink {
+    public:
+        virtual ~JsonSink() {}
+
+        /**
+         * @brief Append bytes to the body.
+         * @return `size_t` Bytes accepted; less than `len` once the sink is full.
+         */
+        virtual size_t write(const uint8_t *data, size_t len) = 0;
+
+        size_t write(uint8_t c) { return this->write(&c, 1); }
+};
+
+/**
+ * @class BufferSink
+ * @brief JsonSink over a caller-owned buffer; bytes beyond its size are dropped.
+ */
+class BufferSink : public JsonSink {
+    public:
+        BufferSink(char *buf = nullptr, size_t size = 0) : __buf__(buf), __size__(size), __len__(0) {}
+
+        using JsonSink::write;
+        size_t write(const uint8_t *data, size_t len) override {
+            size_t n = len < this->__size__ - this->__len__ ? len : this->__size__ - this->__len__;
+            memcpy(this->__buf__ + this->__len__, data, n);
+            this->__len__ += n;
+            return n;
+        }
+
+        const char *data() const { return this->__buf__; }
+        size_t length() const { return this->__len__; }
+
+    private:
+        char *__buf__;      ///< Destination
+        size_t __size__;    ///< Capacity of `__buf__`
+        size_t __len__;     ///< Bytes written so far
+};
+
+/**
+ * @class WebExchange
+ * @brief One HTTP request and its response, as seen by the handler logic.
+ * 
+ * Handlers that take a WebExchange only read arguments and headers and
+ * hand back a finished body; they never touch the server library. The
+ * device uses AsyncWebExchange (AsyncWebExchange.h), the native tests use
+ * MockWebExchange (test/mock). This header only uses the standard library;
+ * strings are valid for the lifetime of the exchange.
+ */
+class WebExchange {
+    public:
+        /**
+         * @brief Produces the next part of a streamed body.
+         * @details Called with a buffer and its size, returns the bytes written; 0 ends the body.
+         */
+        using Filler = std::function<size_t(uint8_t *buf, size_t maxLen)>;
+
+        virtual ~WebExchange() {}
+
+        virtual const char *url() const = 0;
+        virtual bool isGet() const = 0;
+
+        /**
+         * @brief IP address of this device as the client reached it, e.g. "192.168.4.1".
+         */
+        virtual const char *localIP() const = 0;
+
+        virtual size_t args() const = 0;
+        virtual const char *argName(size_t i) const = 0;
+        virtual const char *arg(size_t i) const = 0;
+
+        /**
+         * @brief Look up a request argument.
+         * @param name Argument name.
+         * @return The value, or `nullptr` if the argument is missing.
+         */
+        virtual const char *arg(const char *name) const = 0;
+
+        /**
+         * @brief Look up a request header.
+         * @param name Header name.
+         * @return The value, or `nullptr` if the header is missing.
+         */
+        virtual const char *header(const char *name) const = 0;
+
+        /**
+         * @brief Start a JSON response of a known length.
+         * @param code HTTP status code.
+         * @param len Exact body length, e.g. from `measureJson()`.
+         * @return The sink to serialize the body into; finish with endJson().
+         */
+        virtual JsonSink &beginJson(int code, size_t len) = 0;
+
+        /**
+         * @brief Send the body written into the sink returned by beginJson().
+         */
+        virtual void endJson() = 0;
+
+        /**
+         * @brief Send a raw response body; the data is copied.
+         * @param code HTTP status code.
+         * @param mime Content type.
+         * @param data Body.
+         * @param len Body length.
+         */
+        virtual void send(int code, const char *mime, const uint8_t *data, size_t len) = 0;
+
+        /**
+         * @brief Send a body of unknown length, pulled chunk by chunk.
+         * @param code HTTP status code.
+         * @param mime Content type.
+         * @param filler Called until it returns 0; may outlive the handler.
+         */
+        virtual void sendChunked(int code, const char *mime, Filler filler) = 0;
+};
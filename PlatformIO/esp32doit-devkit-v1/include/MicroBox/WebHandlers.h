@@ -0,0 +1,133 @@
+/**
+ *  @file WebHandlers.h
+ *  @version 1.0.0
+ *  @brief Transport-independent logic of the JSON endpoints and the HTML templates.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+#include <ArduinoJson.h>
+#include "config.h"
+#include "SensorSample.h"
+#include "TelemetryFrame.hpp"
+#include "TemplateRenderer.hpp"
+#include "WebExchange.h"
+
+/**
+ * @struct WebStatus
+ * @brief Device values reported by the data, RTC and telemetry responses.
+ */
+struct WebStatus {
+    SensorSample sample;            ///< Latest sensor sample set
+    char date[RTC_DATE_LEN];        ///< RTC date, "MM/DD/YYYY"
+    char time[RTC_TIME_LEN];        ///< RTC time, 12/24 hour as configured
+    char iso8601[RTC_ISO8601_LEN];  ///< RTC date and time, "YYYY-MM-DDTHH:MM:SS"
+    uint32_t unixtime;              ///< RTC time in unix seconds (local)
+    float totalHeap;                ///< Total heap (KB)
+    float freeHeap;                 ///< Free heap (KB)
+};
+
+/**
+ * @class WebHandlers
+ * @brief Handler logic behind WebExchange, independent of the HTTP transport.
+ * 
+ * Only depends on the standard library and ArduinoJson, so it builds in the
+ * native test environment. The device values come from the two virtual
+ * methods; WebServerClass reads them from the sensors, the RTC and the
+ * settings, the native tests from fixtures.
+ */
+class WebHandlers {
+    public:
+        virtual ~WebHandlers() {}
+
+        /**
+         * Sensor snapshot as JSON, or as a TelemetryFrame if the Accept header asks for one.
+         * @param ex The request/response.
+         */
+        void __dataServer__(WebExchange &ex);
+
+        /**
+         * RTC date and time as JSON.
+         * @param ex The request/response.
+         */
+        void __rtcServer__(WebExchange &ex);
+
+        /**
+         * 404 response echoing the URI, method and arguments.
+         * @param ex The request/response.
+         */
+        void __notFound__(WebExchange &ex);
+
+        /**
+         * Stream an HTML page and substitute its `%TOKEN%` placeholders on the fly.
+         * @param ex The request/response.
+         * @param reader Source of the page bytes; kept until the last chunk is sent.
+         */
+        void __page__(WebExchange &ex, TemplateRenderer::Reader reader);
+
+        /**
+         * Serialize a document into the response of an exchange.
+         * @param ex The request/response.
+         * @param code HTTP status code.
+         * @param doc The response document.
+         */
+        static void __sendJson__(WebExchange &ex, int code, const JsonDocument &doc);
+
+    protected:
+        /**
+         * Read the current device values.
+         * @param status Receives the values.
+         */
+        virtual void __status__(WebStatus &status) = 0;
+
+        /**
+         * Look up the value of one template placeholder; LOCALIP is handled here.
+         * @param name Placeholder name without the `%` delimiters.
+         * @return The value, or `nullptr` if unknown.
+         */
+        virtual const char *__token__(std::string_view name) = 0;
+
+        void __getDataServer__(JsonDocument &doc, const WebStatus &status);
+
+        /**
+         * Add the "heap_memory" object (total and free heap in KB).
+         * @param doc Document with room for two short strings.
+         * @param status Device values.
+         */
+        void __getHeapMemory__(JsonDocument &doc, const WebStatus &status);
+
+        void __getRTCServer__(JsonDocument &doc, const WebStatus &status);
+
+        /**
+         * Fill a TelemetryFrame with the current sensor, RTC and heap values.
+         * @param out Destination, at least TELEMETRY_FRAME_SIZE bytes.
+         * @param topic Topic id stored in the frame header.
+         * @return Number of bytes written.
+         */
+        size_t __encodeTelemetry__(uint8_t *out, uint8_t topic);
+
+    private:
+        class PageRenderer;
+};
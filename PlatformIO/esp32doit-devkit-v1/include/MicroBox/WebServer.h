@@ -30,12 +30,12 @@
 #include <LittleFS.h>
 #include <FS.h>
 #include "info.h"
+#include "config.h"
 #include "MyEEPROM.hpp"
-
-// Define MIME types for HTTP responses
-#define APPJSON   "application/json"
-#define TEXTHTML  "text/html"
-#define TEXTPLAIN "text/plain"
+#include "TelemetryFrame.hpp"
+#include "AsyncWebExchange.h"
+#include "WebHandlers.h"
+#include "RateLimiter.hpp"
 
 extern "C" {
     // Macros for file system operations
@@ -49,7 +49,65 @@ extern "C" {
     #define LFS_WRITE    "w"
 }
 
-class WebServerClass : protected Info_t {
+/**
+ * @brief A pre-compressed static file (css/js) listed in the asset manifest.
+ */
+struct WebAsset {
+    String path;    ///< File path without the ".gz" suffix, e.g. "/WEB/js/clock.js"
+    String etag;    ///< Quoted content hash written by gzip_assets.py
+};
+
+/**
+ * @brief Telemetry topics a WebSocket client can subscribe to.
+ */
+enum WSTopic : uint8_t {
+    WS_TOPIC_DATA_SERVER,   ///< "data_server": sensor snapshot and heap usage
+    WS_TOPIC_DATETIME,      ///< "datetime": RTC date and time
+    WS_TOPIC_COUNT
+};
+
+/**
+ * @brief Push subscription of one WebSocket client.
+ */
+struct WSSubscriber {
+    uint32_t id;                        ///< Client id, 0 if the slot is free
+    uint8_t topics;                     ///< Bit mask of WSTopic
+    bool binary;                        ///< Receive TelemetryFrame instead of JSON
+    uint32_t interval;                  ///< Minimum time between two frames of a topic (ms)
+    uint32_t lastSent[WS_TOPIC_COUNT];  ///< millis() of the last frame per topic
+    uint32_t lastDropped[WS_TOPIC_COUNT]; ///< millis() of the last frame counted as dropped per topic
+    uint32_t backlogSince;              ///< millis() when the queue was first found full, 0 if draining
+};
+
+/**
+ * @brief Rate-limited HTTP routes, for the per-route counters and costs.
+ */
+enum WebRoute : uint8_t {
+    ROUTE_RECOVERY,         ///< /recovery
+    ROUTE_DATA_SERVER,      ///< /data-server
+    ROUTE_HISTORY,          ///< /api/history
+    ROUTE_CONFIG_RTC,       ///< /config-rtc
+    ROUTE_SAVE_RTC,         ///< /save-config-rtc (I2C write)
+    ROUTE_ENABLE_BLYNK,     ///< /enable-blynk
+    ROUTE_REBOOT,           ///< /rst-webserver
+    ROUTE_ASSET,            ///< css/js files
+    ROUTE_NOT_FOUND,        ///< anything else
+    ROUTE_COUNT
+};
+
+/**
+ * @brief Hit and reject counters of one route.
+ */
+struct RouteStats {
+    uint32_t hits;      ///< Requests let through
+    uint32_t rejects;   ///< Requests answered with 429
+};
+
+#if defined(WEB_ASSETS_IN_FLASH)
+struct FlashAsset; // generated by embed_assets.py (WebAssets.h)
+#endif
+
+class WebServerClass : protected Info_t, public WebHandlers {
     public:
         /**
          * Constructor to initialize the web server with a specified port.
@@ -67,6 +125,71 @@ class WebServerClass : protected Info_t {
          */
         void UpdateOTAloop(void);
 
+        /**
+         * Push due telemetry frames to the WebSocket subscribers. Call periodically.
+         * @details Each topic is serialized at most once per call and the same
+         *          buffer is queued to every client it is due for. A client whose
+         *          queue or TCP window is full skips the frame instead of queueing it.
+         */
+        void Broadcast(void);
+
+        /**
+         * Check whether any WebSocket client has a telemetry subscription.
+         * @return `true` if at least one subscription slot is in use.
+         */
+        bool hasSubscribers(void);
+
+        /**
+         * Telemetry frames queued to clients since boot.
+         */
+        uint32_t wsFramesSent(void) const { return this->__wsFramesSent__; }
+
+        /**
+         * Due telemetry frames skipped for slow clients since boot.
+         */
+        uint32_t wsFramesDropped(void) const { return this->__wsFramesDropped__; }
+
+        /**
+         * WebSocket clients closed for exceeding WS_MAX_CLIENTS or WS_STALE_CLIENT_MS.
+         * @return `uint32_t` Count since boot.
+         */
+        uint32_t wsEvictions(void) const { return this->__wsEvictions__; }
+
+        /**
+         * Currently connected WebSocket clients.
+         * @return `size_t` Client count.
+         */
+        size_t wsClients(void) const { return this->ws.count(); }
+
+        /**
+         * Name of a route, as used in the system report.
+         * @param route The route.
+         * @return The path, e.g. "/data-server".
+         */
+        static const char *routeName(WebRoute route);
+
+        /**
+         * Hit and reject counters of a route since boot.
+         * @param route The route.
+         * @return The counters.
+         */
+        RouteStats routeStats(WebRoute route) const { return this->__routeStats__[route]; }
+
+        // The handler logic lives in WebHandlers; the AsyncWebServerRequest
+        // handlers below only wrap the request.
+
+        /**
+         * Confirm and schedule a restart, optionally switching to Blynk mode.
+         * @param ex The request/response.
+         * @param enableBlynk Store Blynk (STA) mode before the restart.
+         */
+        void __restart__(WebExchange &ex, bool enableBlynk);
+
+    protected:
+        // Device values for WebHandlers
+        void __status__(WebStatus &status) override;
+        const char *__token__(std::string_view name) override;
+
     private:
         // Private methods for handling different web server functionalities
 
@@ -75,11 +198,62 @@ class WebServerClass : protected Info_t {
          */
         void Run_css_js_WebServer(void);
 
+        /**
+         * Load the ETag manifest written by gzip_assets.py.
+         * @return `true` if the manifest was found and the gzip assets can be served.
+         */
+        bool __loadAssetManifest__(void);
+
+        /**
+         * Serve one pre-compressed asset with ETag / 304 handling and caching headers.
+         * @param req Pointer to the web server request.
+         * @param asset The asset to serve.
+         */
+        void __serveAsset__(AsyncWebServerRequest *req, const WebAsset &asset);
+
+    #if defined(WEB_ASSETS_IN_FLASH)
+        /**
+         * Register a route for every css/js file compiled into the firmware.
+         */
+        void __registerFlashAssets__(void);
+
+        /**
+         * Serve an HTML page compiled into the firmware, with template processing.
+         * @param ex The request/response.
+         * @param path LittleFS-style path of the page, e.g. "/WEB/html/recovery.html".
+         * @return `false` if the page is not in the firmware.
+         */
+        bool __sendFlashPage__(WebExchange &ex, const String &path);
+
+        /**
+         * Serve one css/js file from flash with ETag / 304 handling and caching headers.
+         * @param req Pointer to the web server request.
+         * @param asset The asset to serve.
+         */
+        void __serveFlashAsset__(AsyncWebServerRequest *req, const FlashAsset &asset);
+    #endif
+
         /**
          * Serve Routes
          */
         void Routes(void);
 
+        /**
+         * Wrap a route handler with the per-IP rate limit and the route counters.
+         * @param route The route, selects the token cost.
+         * @param handler The handler to call for admitted requests.
+         * @return The wrapped handler.
+         */
+        ArRequestHandlerFunction __limit__(WebRoute route, ArRequestHandlerFunction handler);
+
+        /**
+         * Charge a request against its client's bucket; answers 429 if it is empty.
+         * @param req Pointer to the web server request.
+         * @param route The route, selects the token cost.
+         * @return `true` if the handler may run.
+         */
+        bool __admit__(AsyncWebServerRequest *req, WebRoute route);
+
         /**
          * Serve the recovery page.
          * @param req Pointer to the web server request.
@@ -105,37 +279,103 @@ class WebServerClass : protected Info_t {
          */
         void __handleNotFound__(AsyncWebServerRequest *req);
 
-        void __getDataServer__(DynamicJsonDocument &doc);
+        /**
+         * Serialize a document straight into a WebSocket buffer and send it.
+         * @param client The WebSocket client.
+         * @param doc The message document.
+         */
+        void __sendJsonWS__(AsyncWebSocketClient *client, const JsonDocument &doc);
         void DataWebServer(AsyncWebServerRequest *req);
         void handleDataServerWS(AsyncWebSocketClient *client);
 
+        /**
+         * Stream a range of the sensor history as JSON.
+         * Query: `metric` (ph|ntu|capacity), `res` (raw|1m|1h), `from` / `to` (unix seconds).
+         * @param req Pointer to the web server request.
+         */
+        void HistoryServer(AsyncWebServerRequest *req);
+
         void RTCServer(AsyncWebServerRequest *req);
         void RTC_Config_Main(AsyncWebServerRequest *req);
         void Save_RTC_Config(AsyncWebServerRequest *req);
-        void __getRTCServer__(StaticJsonDocument<200> &doc);
         void handleRTCServer(AsyncWebSocketClient *client);
 
         void onEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len);
+
+        /**
+         * Add or update the push subscription of a client.
+         * @param client The WebSocket client.
+         * @param doc The parsed "subscribe" message (topics, interval, format).
+         */
+        void __subscribe__(AsyncWebSocketClient *client, JsonDocument &doc);
+
+        /**
+         * Remove the push subscription of a client.
+         * @param id The client id.
+         */
+        void __unsubscribe__(uint32_t id);
+
+        /**
+         * Evict the oldest WebSocket clients while more than WS_MAX_CLIENTS are connected.
+         */
+        void __reapClients__(void);
+
+        /**
+         * Drop the TCP connection of a client, once per client.
+         * @param client The client, deleted by the call.
+         * @return `true` if evicted now, `false` if it was already evicted.
+         */
+        bool __evictClient__(AsyncWebSocketClient *client);
+
+        /**
+         * Check whether a client id has already been evicted. The caller holds `subscribersMux`.
+         * @param id The client id.
+         */
+        bool __isEvicted__(uint32_t id);
+
+        /**
+         * Serialize one topic into a shared WebSocket buffer.
+         * @param topic The topic to serialize.
+         * @return The buffer, or `nullptr` if it could not be allocated.
+         */
+        AsyncWebSocketMessageBuffer *__serializeTopic__(WSTopic topic);
+
+        /**
+         * Encode one topic as a binary TelemetryFrame into a shared WebSocket buffer.
+         * @param topic The topic, stored in the frame header.
+         * @return The buffer, or `nullptr` if it could not be allocated.
+         */
+        AsyncWebSocketMessageBuffer *__encodeTopic__(WSTopic topic);
         void handleWebSocketMessage(void *arg, uint8_t *data, size_t len);
 
         /**
-         * Read the content of a file into a string buffer.
-         * @param fileName Name of the file to read.
-         * @return Content of the file as a string.
+         * Serve an HTML page from LittleFS (or flash) through WebHandlers::__page__().
+         * @param req Pointer to the web server request.
+         * @param path Path of the HTML file in LittleFS.
          */
-        String file_buffer(String fileName);
+        void __sendTemplate__(AsyncWebServerRequest *req, const String &path);
 
         // Private member variables
         const String DIRCSS  = "/WEB/css/";  ///< Directory for CSS files
         const String DIRHTML = "/WEB/html/"; ///< Directory for HTML files
         const String DIRJS   = "/WEB/js/";   ///< Directory for JavaScript files
+        const String ASSET_MANIFEST = "/WEB/assets.etag"; ///< ETag manifest of the gzip assets
+        std::vector<WebAsset> assets;        ///< Gzip assets from the manifest
+
+        WSSubscriber subscribers[WS_MAX_SUBSCRIBERS] = {};                  ///< Push subscriptions
+        portMUX_TYPE subscribersMux = portMUX_INITIALIZER_UNLOCKED;        ///< Guards `subscribers`
+        uint32_t __wsFramesSent__ = 0;     ///< Frames queued to clients
+        uint32_t __wsFramesDropped__ = 0;  ///< Frames skipped for slow clients
+        uint32_t __wsEvictions__ = 0;      ///< Clients closed by the limits
+        uint32_t __wsEvicted__[WS_MAX_CLIENTS] = {}; ///< Last evicted client ids, guarded by `subscribersMux`
+        uint8_t __wsEvictedNext__ = 0;     ///< Next slot in `__wsEvicted__`
+        RateLimiter limiter;                        ///< Per-IP token buckets
+        RouteStats __routeStats__[ROUTE_COUNT] = {}; ///< Counters per route
 
-        File file;                ///< File object for file operations
         String __LOCALIP__;       ///< Local IP address of the server
         uint16_t __PORT__;        ///< Port number for the server
         AsyncWebServer serverAsync; ///< Async web server instance
         AsyncWebSocket ws;        ///< Async websocket server instance
-        MyEEPROM myeeprom;        ///< EEPROM handler object
 };
 
 #if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_WebServer)
@@ -35,12 +35,29 @@
     #define ADC_RESOLUTION      1023.0 ///< Default ADC resolution for other platforms
 #endif
 
+// Constants for continuous ADC sampling (ESP32 DMA mode).
+#define ADC_SAMPLE_FREQ_HZ      20000   ///< Total conversion rate (ESP32 minimum is 20 kHz)
+#define ADC_OVERSAMPLE          256     ///< Raw conversions averaged into one value
+#define ADC_RING_SIZE           8       ///< Decimated values kept per pin
+#define ADC_DMA_FRAME_BYTES     1024    ///< Bytes handed over per DMA interrupt
+#define ADC_SAMPLER_MAX_PINS    2       ///< Pins scanned by the sampler
+
+// Constants for task scheduling
+#define SENSOR_PERIOD_MS        100     ///< Sensor sampling period of vTask1 (ms), one wakeup per sample
+#define SYS_IDLE_TIMEOUT_MS     500     ///< Longest vTask3 sleep without an event (ms)
+#define NET_POLL_MS             100     ///< vTask2 poll period while Blynk is active (ms)
+
 // Constants for Water Turbidity sensor calibration.
 #define ADC_CLEAN_WATER 2047    ///< ADC value for clean water (0 NTU)
 #define ADC_DIRTY_WATER 1024    ///< ADC value for moderately turbid water (50 NTU)
 #define NTU_CLEAN_WATER 0       ///< NTU value for clean water
 #define NTU_DIRTY_WATER 50      ///< NTU value for moderately turbid water
 
+// Coefficients for the polynomial turbidity curve: NTU = a*V^2 + b*V - c
+#define NTU_POLY_A  -2572.2     ///< Quadratic term
+#define NTU_POLY_B  8700.5      ///< Linear term
+#define NTU_POLY_C  4352.9      ///< Constant term
+
 // Constants for pH sensor calibration.
 #define PH7 2.55    ///< Voltage value for pH 7 (neutral)
 #define PH4 3.1     ///< Voltage value for pH 4 (acidic)
@@ -48,6 +65,8 @@
 // Constants for Ultrasonic Parameters
 #define EMPTY 18        // cm
 #define FULL  5         // cm
+#define ULTRASONIC_MAX_DISTANCE (EMPTY * 2) ///< Farthest echo still accepted (cm)
+#define ULTRASONIC_TIMEOUT_US   (1000UL + (uint32_t)(ULTRASONIC_MAX_DISTANCE * 2 / 0.034)) ///< Echo timeout from trigger (us)
 
 // Constants for Relay Optocoupler
 #define ON  0x0
@@ -56,3 +75,86 @@
 // Constants for Stepper driver
 #define STEPS       300 
 #define SETSPEED    1000
+
+// Constants for Feeder motion state machine
+#define FEEDER_STEPS        800     ///< Steps for one dispense stroke
+#define FEEDER_STEP_CHUNK   50      ///< Max steps moved per FeederSys_run() tick
+#define FEEDER_STEP_INTERVAL_MS 10  ///< Gap between two step chunks (ms)
+#define FEEDER_DWELL_MS     3000    ///< Pause between dispense and retract (ms)
+#define FEEDER_COOLDOWN_MS  3000    ///< Pause after retract before next feed (ms)
+
+// Constants for persistent settings
+#define CONFIG_EEPROM_SIZE          128     ///< Bytes reserved by EEPROM.begin(), rewritten on every commit
+#define CONFIG_SLOT_ADDR            0x10    ///< First of the two settings slots, after the old fixed addresses
+#define CONFIG_SLOT_SIZE            48      ///< Bytes per slot: 16-byte header + payload
+#define CONFIG_MAGIC                0x4643424DUL ///< "MBCF"
+#define CONFIG_VERSION              1       ///< Layout version of SysConfig, bump when appending fields
+#define CONFIG_FLUSH_DELAY_MS       2000    ///< Quiet time before pending settings are committed (ms)
+
+// Constants for web server
+#define WEB_ASSET_CACHE_CONTROL     "public, max-age=604800" ///< Cache-Control of the static css/js files
+
+#define WS_MAX_SUBSCRIBERS          8       ///< WebSocket clients with a telemetry subscription
+#define WS_DEFAULT_INTERVAL_MS      1000    ///< Push interval when the client does not ask for one (ms)
+#define WS_MIN_INTERVAL_MS          250     ///< Fastest push interval a client may request (ms)
+#define WS_MAX_INTERVAL_MS          60000UL ///< Slowest push interval a client may request (ms)
+#define WS_BROADCAST_TICK_MS        250     ///< vTask2 period while there are subscribers (ms)
+#define WS_MAX_CLIENTS              4       ///< Connected WebSocket clients; the oldest is closed beyond this
+#define WS_KEEPALIVE_S              15      ///< Ping idle clients so dead connections time out (s)
+#define WS_STALE_CLIENT_MS          10000UL ///< Close a client whose send queue stays full this long (ms)
+
+// Per-client HTTP rate limit (token bucket per IP, see RateLimiter.hpp)
+#define RATE_LIMIT_CLIENTS          8       ///< Client IPs tracked at once, least recently seen is replaced
+#define RATE_LIMIT_BURST            20      ///< Bucket size, tokens
+#define RATE_LIMIT_PER_S            5       ///< Refill rate, tokens per second
+#define RATE_LIMIT_RETRY_S          "2"     ///< Retry-After of the 429 response (s)
+#define NOT_FOUND_MAX_ARGS          4       ///< Arguments echoed back by the 404 response
+
+// HTML templates (see TemplateRenderer.hpp)
+#define TEMPLATE_TOKEN_LEN          16      ///< Longest placeholder name, longer `%...%` runs are sent as text
+#define TEMPLATE_VALUE_LEN          64      ///< Longest substituted value, longer values are cut (bytes)
+#define TEMPLATE_READ_LEN           128     ///< Page bytes read from the source at a time
+
+// Response buffers (see ResponsePool.hpp)
+#define RESPONSE_POOL_SLOTS         4       ///< Pooled responses that can be in flight at once (max 32)
+#define RESPONSE_POOL_SLOT_SIZE     384     ///< Largest response body served from the pool (bytes)
+#define RESPONSE_JSON_CAPACITY      512     ///< StaticJsonDocument capacity of one JSON response (bytes)
+
+// Sensor history (fixed RAM, see SensorHistory.hpp)
+#define HISTORY_RAW_LEN             240     ///< Raw samples kept, 24 s at SENSOR_PERIOD_MS
+#define HISTORY_MINUTE_LEN          360     ///< 1-minute rollups kept (6 h)
+#define HISTORY_HOUR_LEN            168     ///< 1-hour rollups kept (7 days)
+#define HISTORY_CLOCK_SLACK_S       60      ///< RTC step back absorbed by the history, larger ones restart it
+
+// Persistent time series on LittleFS (see SeriesStore.h)
+#define SERIES_DIR                  "/series" ///< Directory of the segment files
+#define SERIES_RECORD_PERIOD_S      10      ///< Samples averaged into one record (s)
+#define SERIES_BATCH_RECORDS        32      ///< Records collected in RAM before a write (384 bytes)
+#define SERIES_SYNC_INTERVAL_MS     60000UL ///< Longest a record waits in RAM before it is written and synced (ms)
+#define SERIES_SEGMENT_RECORDS      1024    ///< Records per segment file (12 KB; raw ~2.8 h, compacted ~17 h)
+#define SERIES_RAW_SEGMENTS         8       ///< Full-resolution segments kept before compaction
+#define SERIES_COMPACT_FACTOR       6       ///< Raw records averaged into one compacted record (1 min)
+#define SERIES_COMPACT_SEGMENTS     8       ///< Compacted segments kept (~5.7 days)
+
+// Retained across soft resets in RTC slow memory (see RetainedLog.h)
+#define RETAINED_SAMPLES            64      ///< Series records kept, covers the full SeriesStore queue (1 KB)
+#define RETAINED_EVENTS             32      ///< Feed and boot events kept (256 bytes)
+
+// Asynchronous serial logger (see Logger.h)
+#ifndef LOGGER_LEVEL
+#define LOGGER_LEVEL                LOGGER_LEVEL_INFO ///< Records above this level are compiled out
+#endif
+#define LOGGER_SLOTS                32      ///< Records buffered for the drain task, a power of two
+#define LOGGER_RECORD_LEN           128     ///< Longest record text, longer text is cut (bytes)
+#define LOGGER_DRAIN_MS             20      ///< Drain task period (ms)
+
+// Constants for RTC
+#define RTC_SYNC_INTERVAL_MS        60000UL ///< Max age of the cached RTC time before the chip is read again (ms)
+#define RTC_DATE_LEN                11      ///< Date buffer incl. terminator, "MM/DD/YYYY"
+#define RTC_TIME_LEN                12      ///< Time buffer incl. terminator, "HH:MM:SS AM"
+#define RTC_ISO8601_LEN             20      ///< ISO 8601 buffer incl. terminator, "YYYY-MM-DDTHH:MM:SS"
+
+// Constants for Feeding schedule
+#define FEED_SCHEDULE_MAX           8       ///< Max entries in the feeding schedule
+#define FEED_SCHEDULE_GRACE_S       300     ///< A feed later than this is skipped (s)
+#define FEED_SCHEDULE_FALLBACK_MS   60000UL ///< RTC check interval if the alarm interrupt is missed (ms)
@@ -13,12 +13,16 @@
 #include "MyEEPROM.hpp"
 #include "MyStepper.hpp"
 #include "ProgramWiFi.h"
+#include "SensorSnapshot.hpp"
+#include "SensorHistory.hpp"
 
 extern PHSensorClass PHSensor;
 extern WaterTurbidityClass WaterTurbidity;
 extern DS3231rtc rtcprog;
 extern MyEEPROM myeeprom_prog;
 extern MyStepper mystepper;
+extern SensorSnapshot SensorData;
+extern SensorHistory History;
 
 extern unsigned long LastTimeReboot;
 extern bool RebootState;
@@ -11,6 +11,7 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "FeedSchedule.hpp"
 
 // PIN I/O COMPONENTS
 #define BOOTBUTTON          18  ///< Pin for the boot button
@@ -26,8 +27,15 @@ inline const uint16_t PINOUT_STEPPER[2] = {25, 26};  ///< Pins for the stepper m
 #define PIN_TRIGGER         14  ///< Pin for the ultrasonic sensor trigger
 #define PIN_ECHO            12  ///< Pin for the ultrasonic sensor echo
 
+// PIN INPUT RTC
+#define PIN_RTC_INT         27  ///< DS3231 INT/SQW output (alarm interrupt, active low)
+
 // Feeding schedule for the automatic feeder
-inline const String FeedingSchedule[3] = {"7:0:0", "12:0:0", "17:0:0"};  ///< Feeding times
+inline const FeedEntry FeedingSchedule[] = {
+    { FEED_AT(7, 0, 0),  FEED_EVERYDAY },
+    { FEED_AT(12, 0, 0), FEED_EVERYDAY },
+    { FEED_AT(17, 0, 0), FEED_EVERYDAY }
+};  ///< Feeding times (24-hour clock) and days
 
 // Constants for stepper motor control
 #define DEGRESS_STEPPER 360  ///< Stepper motor degrees per step
@@ -28,6 +28,7 @@
 
 #include <Arduino.h>
 #include "MicroBox/EraseEEPROM.hpp"
+#include "MicroBox/config.h"
 
 class MicroBox_Main {
     /****** ADD NEW FUNCTION HERE ******/
@@ -101,7 +102,7 @@ class Main : protected MicroBox_Main {
             Serial.begin(baud);
 
             // Attempt to initialize the EEPROM
-            if (!EraseEEPROM::BEGIN()) {
+            if (!EraseEEPROM::BEGIN(CONFIG_EEPROM_SIZE)) {
                 Serial.println(F("Failed to initialize EEPROM! The run() function cannot be executed."));
                 return;
             }
@@ -0,0 +1,122 @@
+import sys, re, json, struct, argparse
+
+# Render the binary log frames of a -DLOGGER_BINARY build.
+#
+#   python log_decode.py .pio/build/esp32doit-devkit-v1/log_strings.json --port /dev/ttyUSB0
+#   python log_decode.py .pio/build/esp32doit-devkit-v1/log_strings.json capture.bin
+#
+# Frame (see Logger.h): 0xA5 | length | id (4) | millis (4) | payload,
+# little-endian. Bytes outside frames (boot ROM, direct Serial output)
+# are printed as they come.
+
+FRAME_SYNC = 0xA5
+HEADER_LEN = 10
+
+spec_re = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t|L)?([diouxXcsfFeEgGp%])")
+
+class LogDecoder:
+    def __init__(self, table: dict) -> None:
+        self.table = {int(k, 16): v for k, v in table.items()}
+        self.buffer = bytearray()
+
+    def __render__(self, fmt: str, payload: bytes) -> str:
+        pos = 0
+        out = []
+        last = 0
+        for m in spec_re.finditer(fmt):
+            out.append(fmt[last:m.start()])
+            last = m.end()
+            flags, _, conv = m.groups()
+            if conv == "%":
+                out.append("%")
+                continue
+
+            if conv == "s":
+                if pos >= len(payload):
+                    out.append("<?>")
+                    continue
+                n = payload[pos]
+                value = payload[pos + 1:pos + 1 + n].decode("utf-8", errors="replace")
+                pos += 1 + n
+            else:
+                if pos + 4 > len(payload):
+                    out.append("<?>")
+                    continue
+                chunk = payload[pos:pos + 4]
+                pos += 4
+                if conv in "fFeEgG":
+                    value = struct.unpack("<f", chunk)[0]
+                elif conv in "di":
+                    value = struct.unpack("<i", chunk)[0]
+                elif conv == "c":
+                    value = chr(chunk[0])
+                else:
+                    value = struct.unpack("<I", chunk)[0]
+                if conv == "p":
+                    conv, flags = "x", "#" + flags
+                elif conv == "u":
+                    conv = "d"
+            out.append(("%" + flags + conv) % value)
+
+        out.append(fmt[last:])
+        return "".join(out)
+
+    def feed(self, data: bytes):
+        self.buffer += data
+        while self.buffer:
+            sync = self.buffer.find(FRAME_SYNC)
+            if sync != 0:
+                text = self.buffer if sync < 0 else self.buffer[:sync]
+                sys.stdout.write(text.decode("utf-8", errors="replace"))
+                del self.buffer[:len(text)]
+                continue
+
+            if len(self.buffer) < HEADER_LEN:
+                break
+            length = self.buffer[1]
+            ident, millis = struct.unpack_from("<II", self.buffer, 2)
+            entry = self.table.get(ident)
+            if entry is None:
+                # Not a frame after all (or a table from another build)
+                sys.stdout.write("\ufffd")
+                del self.buffer[:1]
+                continue
+            if len(self.buffer) < HEADER_LEN + length:
+                break
+
+            payload = bytes(self.buffer[HEADER_LEN:HEADER_LEN + length])
+            del self.buffer[:HEADER_LEN + length]
+            text = self.__render__(entry["format"], payload).rstrip("\n")
+            sys.stdout.write(f"[{millis:8d}][{entry['level']}][{entry['tag']}] {text}\n")
+        sys.stdout.flush()
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode MicroBox binary log frames")
+    parser.add_argument("table", help="log_strings.json from the build directory")
+    parser.add_argument("input", nargs="?", default="-", help="capture file, '-' for stdin")
+    parser.add_argument("--port", help="read from a serial port instead (needs pyserial)")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    with open(args.table, "r") as f:
+        decoder = LogDecoder(json.load(f))
+
+    if args.port:
+        import serial
+        with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+            while True:
+                decoder.feed(port.read(256))
+    else:
+        stream = sys.stdin.buffer if args.input == "-" else open(args.input, "rb")
+        with stream:
+            while True:
+                data = stream.read(4096)
+                if not data:
+                    break
+                decoder.feed(data)
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
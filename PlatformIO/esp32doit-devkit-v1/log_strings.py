@@ -0,0 +1,78 @@
+import os, re, json
+from SCons.Script import DefaultEnvironment
+
+# Binary logging (-DLOGGER_BINARY in build_flags): the firmware sends only
+# a hash of level, tag and format for each LOG_* call. This script collects
+# the call sites and writes the table log_decode.py needs to render them.
+# Without the flag this script does nothing.
+#
+# Output: $BUILD_DIR/log_strings.json (not checked in)
+
+source_ext = (".c", ".cpp", ".h", ".hpp")
+levels = {"ERROR": 1, "WARN": 2, "INFO": 3, "DEBUG": 4}
+
+# LOG_INFO("tag", "format" "continued", args...)
+call_re = re.compile(r'\bLOG_(ERROR|WARN|INFO|DEBUG)\s*\(\s*"((?:[^"\\]|\\.)*)"\s*,\s*((?:"(?:[^"\\]|\\.)*"\s*)+)')
+literal_re = re.compile(r'"((?:[^"\\]|\\.)*)"')
+escape_re = re.compile(r'\\(x[0-9a-fA-F]{1,2}|[0-7]{1,3}|.)')
+escapes = {"n": "\n", "t": "\t", "r": "\r", "0": "\0", "\\": "\\", '"': '"', "'": "'"}
+
+def unescape(text: str) -> str:
+    def sub(m):
+        e = m.group(1)
+        if e[0] == "x":
+            return chr(int(e[1:], 16))
+        if e[0] in "01234567" and e != "0":
+            return chr(int(e, 8))
+        return escapes.get(e, e)
+    return escape_re.sub(sub, text)
+
+def fnv1a(level: int, tag: str, fmt: str) -> int:
+    # Same as LoggerClass::hash()
+    h = 2166136261
+    for b in bytes([level]) + tag.encode() + b"\0" + fmt.encode():
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+class LogStrings:
+    def __init__(self, dirs: list, output: str) -> None:
+        self.dirs = dirs
+        self.output = output
+        self.table = {}
+
+    def __scan_file__(self, path: str):
+        with open(path, "r", encoding="utf-8", errors="replace") as f:
+            content = f.read()
+
+        for m in call_re.finditer(content):
+            level = levels[m.group(1)]
+            tag = unescape(m.group(2))
+            fmt = "".join(unescape(s) for s in literal_re.findall(m.group(3)))
+            key = f"{fnv1a(level, tag, fmt):08x}"
+            where = f"{os.path.relpath(path)}:{content.count(chr(10), 0, m.start()) + 1}"
+
+            entry = self.table.get(key)
+            if entry and (entry["tag"], entry["format"], entry["level"]) != (tag, fmt, m.group(1)[0]):
+                raise ValueError(f"log id {key} collides: {entry['where']} and {where}")
+            self.table[key] = {"level": m.group(1)[0], "tag": tag, "format": fmt, "where": where}
+
+    def process(self):
+        for d in self.dirs:
+            for root, _, files in os.walk(d):
+                for name in sorted(files):
+                    if name.endswith(source_ext):
+                        self.__scan_file__(os.path.join(root, name))
+
+        os.makedirs(os.path.dirname(self.output), exist_ok=True)
+        with open(self.output, "w") as f:
+            json.dump(self.table, f, indent=1, sort_keys=True)
+
+        print(f"log strings: {len(self.table)} call sites -> {self.output}")
+
+env = DefaultEnvironment()
+
+if "LOGGER_BINARY" in env.subst("$BUILD_FLAGS"):
+    LogStrings(
+        [env.subst("$PROJECT_SRC_DIR"), env.subst("$PROJECT_INCLUDE_DIR")],
+        os.path.join(env.subst("$BUILD_DIR"), "log_strings.json"),
+    ).process()
@@ -0,0 +1,147 @@
+/**
+ *  @file ADCSampler.cpp
+ *  @version 1.0.0
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MicroBox/ADCSampler.h"
+#include "MicroBox/Logger.h"
+
+bool ADCSamplerClass::begin(const uint8_t *pins, uint8_t count, uint32_t sample_freq) {
+    if (this->__running__ || count == 0 || count > ADC_SAMPLER_MAX_PINS) return false;
+
+    uint16_t adc1_mask = 0;
+    adc_digi_pattern_config_t pattern[ADC_SAMPLER_MAX_PINS] = {};
+
+    for (uint8_t i = 0; i < count; i++) {
+        int8_t channel = digitalPinToAnalogChannel(pins[i]);
+        // The digital controller only drives ADC1 on the ESP32
+        if (channel < 0 || channel >= ADC1_CHANNEL_MAX) {
+            LOG_ERROR("adc", "pin %u is not an ADC1 pin", pins[i]);
+            return false;
+        }
+
+        Channel &ch = this->__channels__[i];
+        memset(&ch, 0, sizeof(ch));
+        ch.pin = pins[i];
+        ch.channel = channel;
+
+        adc1_mask |= BIT(channel);
+        pattern[i].atten = ADC_ATTEN_DB_11; // Same range as analogRead()
+        pattern[i].channel = channel;
+        pattern[i].unit = 0;                // ADC1
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+    this->__count__ = count;
+
+    adc_digi_init_config_t init_config = {};
+    init_config.max_store_buf_size = ADC_DMA_FRAME_BYTES * 4;
+    init_config.conv_num_each_intr = ADC_DMA_FRAME_BYTES;
+    init_config.adc1_chan_mask = adc1_mask;
+    init_config.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&init_config) != ESP_OK) {
+        LOG_ERROR("adc", "driver initialization failed");
+        return false;
+    }
+
+    adc_digi_configuration_t dig_config = {};
+    dig_config.conv_limit_en = 1;   // Must be set on the ESP32
+    dig_config.conv_limit_num = 250;
+    dig_config.pattern_num = count;
+    dig_config.adc_pattern = pattern;
+    dig_config.sample_freq_hz = sample_freq;
+    dig_config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    dig_config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+    if (adc_digi_controller_configure(&dig_config) != ESP_OK || adc_digi_start() != ESP_OK) {
+        LOG_ERROR("adc", "controller configuration failed");
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    this->__running__ = true;
+    xTaskCreateUniversal(ADCSamplerClass::__task__, "ADCSampler", 3072, this, 2, NULL, APP_CPU_NUM);
+    return true;
+}
+
+bool ADCSamplerClass::read(uint8_t pin, uint16_t &value) const {
+    for (uint8_t i = 0; i < this->__count__; i++) {
+        const Channel &ch = this->__channels__[i];
+        if (ch.pin == pin) {
+            if (!ch.ready) return false;
+            value = ch.value; // 16-bit store/load is atomic, no lock needed
+            return true;
+        }
+    }
+    return false;
+}
+
+void ADCSamplerClass::__task__(void *pvParameter) {
+    static_cast<ADCSamplerClass *>(pvParameter)->__drain__();
+}
+
+void ADCSamplerClass::__drain__() {
+    static uint8_t buffer[ADC_DMA_FRAME_BYTES];
+
+    while (1) {
+        uint32_t length = 0;
+        // Blocks until the DMA hands over a full frame
+        esp_err_t ret = adc_digi_read_bytes(buffer, sizeof(buffer), &length, ADC_MAX_DELAY);
+        if (ret == ESP_ERR_INVALID_STATE) {
+            this->__overruns__++; // Driver buffer was full, older samples were dropped
+        } else if (ret != ESP_OK) {
+            continue;
+        }
+
+        for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length; i += SOC_ADC_DIGI_RESULT_BYTES) {
+            const adc_digi_output_data_t *sample = reinterpret_cast<const adc_digi_output_data_t *>(&buffer[i]);
+            uint8_t channel = sample->type1.channel;
+
+            for (uint8_t c = 0; c < this->__count__; c++) {
+                if (this->__channels__[c].channel == channel) {
+                    this->__push__(this->__channels__[c], sample->type1.data);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void ADCSamplerClass::__push__(Channel &ch, uint16_t raw) {
+    ch.accumulator += raw;
+    if (++ch.count < ADC_OVERSAMPLE) return;
+
+    // Decimate the block and replace the oldest ring entry
+    uint16_t decimated = ch.accumulator / ch.count;
+    ch.accumulator = 0;
+    ch.count = 0;
+
+    if (ch.filled == ADC_RING_SIZE) ch.ringSum -= ch.ring[ch.head];
+    else ch.filled++;
+    ch.ring[ch.head] = decimated;
+    ch.ringSum += decimated;
+    ch.head = (ch.head + 1) % ADC_RING_SIZE;
+
+    ch.value = ch.ringSum / ch.filled;
+    ch.ready = true;
+}
+
+#if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_ADCSampler)
+ADCSamplerClass ADCSampler;
+#endif
@@ -27,14 +27,15 @@
 // Include MicroBox Headers
 #include "MicroBox/BlynkProgram.h"
 #include "MicroBox/ProgramWiFi.h"
-#include "MicroBox/MyEEPROM.hpp"
+#include "MicroBox/ConfigStore.hpp"
 #include "MicroBox/externprog.h"
+#include "MicroBox/SysEvents.h"
+#include "MicroBox/Logger.h"
 
 // Include Blynk Library
 #include "envBlynk.h"
 #include <BlynkSimpleEsp32.h>
 
-MyEEPROM myeeprom; ///< EEPROM utility module
 BlynkTimer Timer;  ///< Blynk timer object for periodic tasks
 
 bool switch_state; ///< State variable for switch control
@@ -59,8 +60,7 @@ BLYNK_WRITE(V4) {
  */
 /*
 BLYNK_WRITE(V3) {
-    myeeprom.save_wifi_state(false);
-    delay(50);
+    ConfigStore::setWifiMode(false);
     LastTimeReboot = millis();
     RebootState = true;
 }
@@ -73,13 +73,14 @@ BLYNK_WRITE(V3) {
  *          Manual feeding is disabled if auto-feeder is active.
  */
 BLYNK_WRITE(V2) {
-    bool read_auto_control = myeeprom.read(ADDR_EEPROM_AUTO_CONTROL);
+    bool read_auto_control = ConfigStore::autoControl();
     if (read_auto_control) {
         Blynk.virtualWrite(V1, read_auto_control);
         return;
     }
 
     switch_state = param.asInt() == 1 ? true : false;
+    if (switch_state) SysEvents::set(SYS_EVT_FEED_REQUEST);
 }
 
 /**
@@ -87,7 +88,7 @@ BLYNK_WRITE(V2) {
  * @param V1 Virtual pin for auto-feeder configuration.
  */
 BLYNK_WRITE(V1) {
-    myeeprom.save_state_auto_control(param.asInt() == 1 ? true : false);
+    ConfigStore::setAutoControl(param.asInt() == 1 ? true : false);
 }
 
 /**
@@ -99,7 +100,8 @@ void sendNTUValue(void) {
     static unsigned long LastMillis_SendData = 0;
     if ((unsigned long) (millis() - LastMillis_SendData) >= 100L) {
         LastMillis_SendData = millis();
-        Blynk.virtualWrite(V4, WaterTurbidity.NTU_value);
+        SensorSample sample;
+        if (SensorData.read(sample)) Blynk.virtualWrite(V4, sample.ntu);
     }
 }
 
@@ -112,7 +114,8 @@ void sendPHValue(void) {
     static unsigned long LastMillis_SendData = 0;
     if ((unsigned long) (millis() - LastMillis_SendData) >= 100L) {
         LastMillis_SendData = millis();
-        Blynk.virtualWrite(V3, PHSensor.PH_value);
+        SensorSample sample;
+        if (SensorData.read(sample)) Blynk.virtualWrite(V3, sample.ph);
     }
 }
 
@@ -125,7 +128,8 @@ void sendCapacity(void) {
     static unsigned long LastMillis_SendData = 0;
     if ((unsigned long) (millis() - LastMillis_SendData) >= 100L) {
         LastMillis_SendData = millis();
-        Blynk.virtualWrite(V0, ultrasonic_capacity);
+        SensorSample sample;
+        if (SensorData.read(sample)) Blynk.virtualWrite(V0, sample.capacity);
     }
 }
 
@@ -135,8 +139,7 @@ void sendCapacity(void) {
  */
 void Blynk_setup() {
     if (WiFi.getMode() == WIFI_STA) {
-        Serial.println(F("Initialize Blynk"));
-        Serial.printf("SSID : %s\nPassword : %s\n", 
+        LOG_INFO("blynk", "Initialize Blynk, SSID : %s, Password : %s",
             ProgramWiFi.__SSID_STA__.c_str(), ProgramWiFi.__PASSWORD_STA__.c_str()
         );
         
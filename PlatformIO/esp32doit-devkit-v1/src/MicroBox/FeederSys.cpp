@@ -25,71 +25,235 @@
 #include "MicroBox/BlynkProgram.h"
 #include "MicroBox/externprog.h"
 #include "MicroBox/variable.h"
+#include "MicroBox/SysEvents.h"
+#include "MicroBox/ConfigStore.hpp"
+#include "MicroBox/RetainedLog.h"
 
-// Variables to track the timing for manual and automatic stepper control
-unsigned long LastTimeRTC = 0;
+/**
+ * Feed cycle states. Each FeederSys_run() call advances the machine by
+ * at most FEEDER_STEP_CHUNK motor steps, so one tick stays bounded.
+ */
+enum FeederState : uint8_t {
+    FEEDER_IDLE,     ///< Waiting for a manual or scheduled feed request
+    FEEDER_DISPENSE, ///< Rotating forward to drop the feed
+    FEEDER_DWELL,    ///< Holding position before retract
+    FEEDER_RETRACT,  ///< Rotating back to the home position
+    FEEDER_COOLDOWN  ///< Holding off before the next feed may start
+};
+
+// Variables to track manual and automatic stepper requests
 bool stateStepperManual = false;
 bool stateStepperAuto = false;
 
-const uint16_t stepMotor = 800; // Number of steps for the motor
+FeederState feederState = FEEDER_IDLE; // Current feed cycle state
+unsigned long feederStateMillis = 0;   // Timestamp of the last state change
+uint16_t feederStepsLeft = 0;          // Steps remaining in the current stroke
+uint32_t feederWorstLoopTime = 0;      // Worst FeederSys_run() time (us)
+volatile bool feederAwaitingSensor = false; // A manual feed waits for the sensor check
+volatile bool feederRelayOn = false;   // Last relay state written by FeederSys_run()
+
+// Feeding schedule, sorted once at startup
+static const FeedSchedule feedSchedule(FeedingSchedule, sizeof(FeedingSchedule) / sizeof(FeedingSchedule[0]));
+uint32_t feedNextDue = 0;              // Unix time of the armed alarm, 0 if none
+unsigned long feedLastCheck = 0;       // Timestamp of the last RTC check
+volatile bool feedAlarmPending = false; // Set by the RTC alarm interrupt
+volatile bool feedScheduleArmed = false; // Cleared to force a re-arm
+
+// DS3231 INT/SQW falling edge: Alarm1 matched
+static void IRAM_ATTR FeederSys_alarmISR() {
+    feedAlarmPending = true;
+    SysEvents::setFromISR(SYS_EVT_SCHEDULE_DUE);
+}
+
+// Program the DS3231 Alarm1 with the first schedule entry after `now`
+static void FeederSys_arm(uint32_t now) {
+    feedNextDue = feedSchedule.nextAfter(now);
+    rtcprog.clearAlarm(1);
+    if (feedNextDue != 0) {
+        // Date mode matches day of month, hour, minute and second
+        rtcprog.setAlarm1(DateTime(feedNextDue), DS3231_A1_Date);
+    }
+    feedScheduleArmed = true;
+}
+
+// Return true once when a scheduled feed is due
+static bool FeederSys_scheduleDue() {
+    bool alarm = feedAlarmPending;
+    if (alarm) feedAlarmPending = false;
+
+    // Only touch the RTC on an alarm, a re-arm request or the slow fallback check
+    if (!alarm && feedScheduleArmed && (unsigned long)(millis() - feedLastCheck) < FEED_SCHEDULE_FALLBACK_MS) {
+        return false;
+    }
+    feedLastCheck = millis();
+
+    // Exact read, the cached clock may lag the alarm by up to a second
+    uint32_t now = rtcprog.sync().unixtime();
+    if (!feedScheduleArmed) {
+        FeederSys_arm(now);
+        return false;
+    }
+    if (feedNextDue == 0 || now < feedNextDue) return false;
+
+    // Skip a feed that is far overdue (e.g. after a clock jump) and re-arm
+    bool onTime = (now - feedNextDue) <= FEED_SCHEDULE_GRACE_S;
+    FeederSys_arm(now);
+    return onTime;
+}
+
+// Switch the feeder to a new state and stamp the time
+static void FeederSys_enter(FeederState state) {
+    feederState = state;
+    feederStateMillis = millis();
+    if (state == FEEDER_DISPENSE || state == FEEDER_RETRACT) {
+        feederStepsLeft = FEEDER_STEPS;
+    }
+}
+
+// Move at most FEEDER_STEP_CHUNK steps, return true when the stroke is done
+static bool FeederSys_stroke(int direction) {
+    uint16_t chunk = (feederStepsLeft > FEEDER_STEP_CHUNK) ? FEEDER_STEP_CHUNK : feederStepsLeft;
+    mystepper.step(direction * chunk);
+    feederStepsLeft -= chunk;
+    return feederStepsLeft == 0;
+}
+
+// Advance the feed cycle by one tick
+static void FeederSys_tick() {
+    unsigned long elapsed = millis() - feederStateMillis;
+
+    switch (feederState) {
+        case FEEDER_IDLE:
+            if (stateStepperManual || stateStepperAuto) {
+                RetainedLog::event(RETAINED_EVT_FEED, stateStepperAuto, rtcprog.now().unixtime());
+                stateStepperManual = false;
+                stateStepperAuto = false;
+                FeederSys_enter(FEEDER_DISPENSE);
+            }
+            break;
+
+        case FEEDER_DISPENSE:
+            if (FeederSys_stroke(1)) FeederSys_enter(FEEDER_DWELL);
+            break;
+
+        case FEEDER_DWELL:
+            if (elapsed >= FEEDER_DWELL_MS) FeederSys_enter(FEEDER_RETRACT);
+            break;
+
+        case FEEDER_RETRACT:
+            if (FeederSys_stroke(-1)) FeederSys_enter(FEEDER_COOLDOWN);
+            break;
+
+        case FEEDER_COOLDOWN:
+            if (elapsed >= FEEDER_COOLDOWN_MS) FeederSys_enter(FEEDER_IDLE);
+            break;
+    }
+}
 
 // Function to control the feeder manually
 void FeederSys_manual() {
-    if (stateStepperManual) {
-        mystepper.step(stepMotor);
-        delay(3000);
-        mystepper.step(-stepMotor);
-        delay(3000);
-        stateStepperManual = false;
+    if (feederState == FEEDER_IDLE) {
+        stateStepperManual = true;
     }
 }
 
 // Function to control the feeder automatically based on the schedule
 void FeederSys_auto() {
-    for (const auto schedule : FeedingSchedule) {
-        // Update RTC time every second
-        if ((unsigned long)(millis() - LastTimeRTC) >= 1000) {
-            LastTimeRTC = millis();
-
-            // Check if the current time matches the feeding schedule
-            if (rtcprog.timestr() == schedule) {
-                stateStepperAuto = true;
-            }
-        }
+    if (feederState == FEEDER_IDLE) {
+        stateStepperAuto = true;
     }
+}
 
-    // Run the stepper motor based on automatic control state
-    if (stateStepperAuto) {
-        mystepper.step(stepMotor);
-        delay(3000);
-        mystepper.step(-stepMotor);
-        delay(3000);
-        stateStepperAuto = false;
-    }
+void FeederSys_begin() {
+    // Route Alarm1 to the INT/SQW pin and keep Alarm2 quiet
+    rtcprog.writeSqwPinMode(DS3231_OFF);
+    rtcprog.disableAlarm(2);
+    rtcprog.clearAlarm(2);
+
+    pinMode(PIN_RTC_INT, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(PIN_RTC_INT), FeederSys_alarmISR, FALLING);
+    feedScheduleArmed = false;
+}
+
+void FeederSys_rearmSchedule() {
+    feedScheduleArmed = false;
 }
 
 // Main function to control the feeder system
 void FeederSys_run() {
-    // Read the control mode from EEPROM
-    bool read_auto_control = myeeprom_prog.read(ADDR_EEPROM_AUTO_CONTROL);
+    uint32_t start = micros();
+
+    // Read the control mode from the settings cache
+    bool read_auto_control = ConfigStore::autoControl();
+
+    // Consume the schedule alarm even if the feed cannot run now
+    bool feedDue = FeederSys_scheduleDue();
+
+    // Take one consistent sample set (all zero until vTask1 publishes the first one)
+    SensorSample sensor = {};
+    SensorData.read(sensor);
     
-    // Check water turbidity and control the relay accordingly
-    if (WaterTurbidity.NTU_value >= 1.3 || (PHSensor.PH_value <= 6.5 || PHSensor.PH_value >= 7.2)) {
-        digitalWrite(PIN_RELAY, ON);
-    } else {
-        digitalWrite(PIN_RELAY, OFF);
-    }
+    // Check water turbidity and pH and control the relay accordingly
+    bool relay = FeederSys_relayWanted(sensor.ph, sensor.ntu);
+    digitalWrite(PIN_RELAY, relay ? ON : OFF);
+    feederRelayOn = relay;
 
     // Check the capacity of the ultrasonic sensor
-    if (ultrasonic_capacity > 0 && WaterTurbidity.NTU_value <= 1.3) {
+    bool feedAllowed = sensor.capacity > 0 && sensor.ntu <= 1.3;
+    if (feedAllowed) {
         // Run automatic feeder system if the control mode is set to auto
-        if (read_auto_control) {
+        if (read_auto_control && feedDue) {
             FeederSys_auto();
         }
         // Run manual feeder system if the control mode is set to manual
         if (!read_auto_control && switch_state) {
-            stateStepperManual = true;
             FeederSys_manual();
         }
     }
+
+    // A held manual switch is decided again as soon as a new sample arrives
+    feederAwaitingSensor = !feedAllowed && !read_auto_control && switch_state && feederState == FEEDER_IDLE;
+
+    // A started cycle always runs to completion so the feeder ends retracted
+    FeederSys_tick();
+
+    uint32_t elapsed = micros() - start;
+    if (elapsed > feederWorstLoopTime) feederWorstLoopTime = elapsed;
+}
+
+bool FeederSys_busy() {
+    return feederState != FEEDER_IDLE;
+}
+
+bool FeederSys_awaitingSensor() {
+    return feederAwaitingSensor;
+}
+
+bool FeederSys_relayWanted(float ph, float ntu) {
+    return ntu >= 1.3 || ph <= 6.5 || ph >= 7.2;
+}
+
+bool FeederSys_relayOn() {
+    return feederRelayOn;
+}
+
+uint32_t FeederSys_nextDeadline() {
+    unsigned long elapsed = millis() - feederStateMillis;
+
+    switch (feederState) {
+        case FEEDER_DISPENSE:
+        case FEEDER_RETRACT:
+            return FEEDER_STEP_INTERVAL_MS;
+        case FEEDER_DWELL:
+            return (elapsed >= FEEDER_DWELL_MS) ? 0 : FEEDER_DWELL_MS - elapsed;
+        case FEEDER_COOLDOWN:
+            return (elapsed >= FEEDER_COOLDOWN_MS) ? 0 : FEEDER_COOLDOWN_MS - elapsed;
+        default:
+            // A pending request is picked up on the next tick
+            return (stateStepperManual || stateStepperAuto) ? 0 : UINT32_MAX;
+    }
+}
+
+uint32_t FeederSys_worstLoopTime() {
+    return feederWorstLoopTime;
 }
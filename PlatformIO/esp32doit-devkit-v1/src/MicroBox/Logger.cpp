@@ -0,0 +1,123 @@
+/**
+ *  @file Logger.cpp
+ *  @version 1.0.0
+ *  @brief Leveled serial logger that never blocks the caller.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "MicroBox/Logger.h"
+
+static_assert((LOGGER_SLOTS & (LOGGER_SLOTS - 1)) == 0, "LOGGER_SLOTS must be a power of two");
+static_assert(LOGGER_RECORD_LEN <= UINT8_MAX, "LOGGER_RECORD_LEN must fit the frame length byte");
+
+#ifndef LOGGER_BINARY
+static const char LOGGER_LEVEL_CHARS[] = { '-', 'E', 'W', 'I', 'D' };
+#endif
+
+void LoggerClass::begin() {
+    if (this->__taskHandle__ != NULL) return;
+    xTaskCreateUniversal(LoggerClass::__task__, "Logger", 3072, this, tskIDLE_PRIORITY, &this->__taskHandle__, tskNO_AFFINITY);
+}
+
+bool LoggerClass::write(uint8_t level, const char *tag, const char *format, ...) {
+    uint32_t index;
+    Slot *slot = this->__reserve__(index);
+    if (slot == nullptr) return false;
+
+    slot->level = level;
+    slot->tag = tag;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(slot->text, sizeof(slot->text), format, args);
+    va_end(args);
+
+    this->__commit__(*slot, index);
+    return true;
+}
+
+LoggerClass::Slot *LoggerClass::__reserve__(uint32_t &index) {
+    // The tail read here can only be stale towards "fuller"
+    index = this->__head__.load(std::memory_order_relaxed);
+    do {
+        if (index - this->__tail__.load(std::memory_order_acquire) >= LOGGER_SLOTS) {
+            this->__dropped__.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    } while (!this->__head__.compare_exchange_weak(index, index + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    Slot *slot = &this->__slots__[index & (LOGGER_SLOTS - 1)];
+    slot->millis = millis();
+    return slot;
+}
+
+void LoggerClass::__commit__(Slot &slot, uint32_t index) {
+    slot.seq.store(index + 1, std::memory_order_release);
+    this->__written__.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LoggerClass::__task__(void *pvParameter) {
+    LoggerClass *self = static_cast<LoggerClass *>(pvParameter);
+    while (1) {
+        self->__drain__();
+        vTaskDelay(pdMS_TO_TICKS(LOGGER_DRAIN_MS));
+    }
+}
+
+void LoggerClass::__drain__() {
+    uint32_t tail = this->__tail__.load(std::memory_order_relaxed);
+    while (tail != this->__head__.load(std::memory_order_acquire)) {
+        Slot &slot = this->__slots__[tail & (LOGGER_SLOTS - 1)];
+        // Reserved but still being formatted; records stay in order, so wait for it
+        if (slot.seq.load(std::memory_order_acquire) != tail + 1) break;
+
+        this->__emit__(slot);
+        this->__tail__.store(++tail, std::memory_order_release);
+    }
+
+#if LOGGER_LEVEL >= LOGGER_LEVEL_WARN
+    // Reported through the ring like any record; retried on the next pass if it is full again
+    uint32_t dropped = this->__dropped__.load(std::memory_order_relaxed);
+    if (dropped != this->__reported__) {
+        uint32_t lost = dropped - this->__reported__;
+        if (LOG_WARN("log", "%u records dropped", lost)) this->__reported__ = dropped;
+    }
+#endif
+}
+
+void LoggerClass::__emit__(const Slot &slot) {
+#ifdef LOGGER_BINARY
+    uint8_t frame[10 + LOGGER_RECORD_LEN];
+    frame[0] = LOGGER_FRAME_SYNC;
+    frame[1] = slot.length;
+    memcpy(frame + 2, &slot.id, sizeof(slot.id));
+    memcpy(frame + 6, &slot.millis, sizeof(slot.millis));
+    memcpy(frame + 10, slot.text, slot.length);
+    Serial.write(frame, 10 + slot.length);
+#else
+    Serial.printf("[%8u][%c][%s] %s\n", slot.millis,
+        LOGGER_LEVEL_CHARS[slot.level < sizeof(LOGGER_LEVEL_CHARS) ? slot.level : 0], slot.tag, slot.text);
+#endif
+}
+
+#if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_Logger)
+LoggerClass Logger;
+#endif
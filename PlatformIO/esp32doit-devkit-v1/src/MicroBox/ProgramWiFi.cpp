@@ -23,21 +23,23 @@
 
 #include "MicroBox/ProgramWiFi.h"
 #include "MicroBox/SysHandlers.h"
+#include "MicroBox/SysEvents.h"
+#include "MicroBox/Logger.h"
 
 // run program if WiFi connecting
 void ProgramWiFiClass::WiFiStationConnected(WiFiEvent_t event, WiFiEventInfo_t info) {
-    Serial.println(F("\nConnection to AP Successfully"));
+    LOG_INFO("wifi", "Connection to AP successful");
+    SysEvents::set(SYS_EVT_NETWORK);
 }
 
 // run program if wifi disconnected
 void ProgramWiFiClass::WiFiStationDisconnected(WiFiEvent_t event, WiFiEventInfo_t info) {
+    SysEvents::set(SYS_EVT_NETWORK);
     static unsigned long LastMillis = 0;
     if ((unsigned long) (millis() - LastMillis) >= 15000L && WiFi.status() != WL_CONNECTED)
     {
         LastMillis = millis();
-        Serial.println(F("Disconnected from WiFi Access Point"));
-        Serial.print(F("WiFi lost connection, Reason "));
-        Serial.println(info.wifi_sta_disconnected.reason);
+        LOG_WARN("wifi", "Disconnected from WiFi access point, reason %u", info.wifi_sta_disconnected.reason);
         WiFi.begin(this->__SSID_STA__.c_str(), this->__PASSWORD_STA__.c_str());
     }
 }
@@ -45,9 +47,8 @@ void ProgramWiFiClass::WiFiStationDisconnected(WiFiEvent_t event, WiFiEventInfo_
 // got ip address if wifi connected
 void ProgramWiFiClass::WiFiGotIP(WiFiEvent_t event, WiFiEventInfo_t info) {
     this->__LOCALIPServer__ = WiFi.localIP().toString().c_str();
-    Serial.println(F("WiFi Connected"));
-    Serial.print(F("IP Address: "));
-    Serial.println(this->__LOCALIPServer__);
+    LOG_INFO("wifi", "WiFi connected, IP address %s", this->__LOCALIPServer__.c_str());
+    SysEvents::set(SYS_EVT_NETWORK);
 }
 
 // Run program Mode STA
@@ -84,7 +85,7 @@ void ProgramWiFiClass::__wifi_mode_sta__() {
 
     // Attempt to connect to WiFi
     WiFi.begin(this->__SSID_STA__.c_str(), this->__PASSWORD_STA__.c_str());
-    Serial.println(F("Connecting to WiFi..."));
+    LOG_INFO("wifi", "Connecting to WiFi...");
     while (WiFi.status() != WL_CONNECTED) {
         this->__bootBtn__.ChageWiFiMode();
         AutoChangeState::run();
@@ -92,8 +93,7 @@ void ProgramWiFiClass::__wifi_mode_sta__() {
     }
 
     // RSSI
-    Serial.print(F("\nRSSI: "));
-    Serial.println(WiFi.RSSI());
+    LOG_INFO("wifi", "RSSI %d dBm", WiFi.RSSI());
 }
 
 // run program mode AP
@@ -106,9 +106,7 @@ void ProgramWiFiClass::__wifi_mode_ap__() {
 
     // get IP Address
     this->__LOCALIPServer__ = WiFi.softAPIP().toString().c_str();
-    Serial.print(F("IP Address: "));
-    Serial.println(this->__LOCALIPServer__);
-    Serial.println();
+    LOG_INFO("wifi", "Access point IP address %s", this->__LOCALIPServer__.c_str());
 }
 
 #if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_ProgramWiFi)
@@ -0,0 +1,183 @@
+/**
+ *  @file RetainedLog.cpp
+ *  @version 1.0.0
+ *  @brief Sample and event ring in RTC slow memory that survives soft resets.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "MicroBox/RetainedLog.h"
+#include <esp_system.h>
+#include "MicroBox/Logger.h"
+
+#define RETAINED_MAGIC  0x4D42524CUL    // "MBRL"
+
+/**
+ * @brief Layout of the retained area. Changing it changes the magic.
+ */
+struct RetainedSample {
+    SeriesRecord record;
+    uint16_t check;
+};
+
+struct RetainedArea {
+    uint32_t magic;             ///< RETAINED_MAGIC ^ sizeof(RetainedArea)
+    uint32_t sampleCount;       ///< Records written; the slot is count % RETAINED_SAMPLES
+    uint32_t eventCount;        ///< Events written
+    uint8_t reason;             ///< RebootReason for the next software restart
+    RetainedSample samples[RETAINED_SAMPLES];
+    RetainedEvent events[RETAINED_EVENTS];
+};
+
+static RTC_NOINIT_ATTR RetainedArea retained;
+static portMUX_TYPE retainedMux = portMUX_INITIALIZER_UNLOCKED;
+static RebootReason retainedBootReason = REBOOT_UNKNOWN;
+
+static const char *const REBOOT_REASON_NAMES[REBOOT_REASON_COUNT] = {
+    "unknown", "power-on", "software", "panic", "watchdog", "brownout",
+    "web", "enable-blynk", "wifi-offline", "button"
+};
+
+// Fletcher-16, enough to reject an entry that was half written when the core went down
+static uint16_t RetainedLog_check(const void *data, size_t length) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint16_t a = 0, b = 0;
+    for (size_t i = 0; i < length; i++) {
+        a = (a + bytes[i]) % 255;
+        b = (b + a) % 255;
+    }
+    return (b << 8) | a;
+}
+
+static uint16_t RetainedLog_check(const RetainedEvent &entry) {
+    return RetainedLog_check(&entry, offsetof(RetainedEvent, check));
+}
+
+static RebootReason RetainedLog_resetReason(esp_reset_reason_t reset, bool valid) {
+    switch (reset) {
+        case ESP_RST_POWERON:
+        case ESP_RST_EXT:       return REBOOT_POWER_ON;
+        case ESP_RST_SW:        return valid && retained.reason < REBOOT_REASON_COUNT ? (RebootReason)retained.reason : REBOOT_SOFTWARE;
+        case ESP_RST_PANIC:     return REBOOT_PANIC;
+        case ESP_RST_INT_WDT:
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_WDT:       return REBOOT_WATCHDOG;
+        case ESP_RST_BROWNOUT:  return REBOOT_BROWNOUT;
+        default:                return REBOOT_UNKNOWN;
+    }
+}
+
+void RetainedLog::begin(uint32_t now) {
+    esp_reset_reason_t reset = esp_reset_reason();
+
+    // After power-on the memory holds noise, even if it happens to look valid
+    bool valid = retained.magic == (RETAINED_MAGIC ^ sizeof(RetainedArea)) &&
+                 reset != ESP_RST_POWERON && reset != ESP_RST_EXT;
+    retainedBootReason = RetainedLog_resetReason(reset, valid);
+
+    if (!valid) {
+        memset(&retained, 0, sizeof(retained));
+        retained.magic = RETAINED_MAGIC ^ sizeof(RetainedArea);
+    }
+    retained.reason = REBOOT_SOFTWARE;
+
+    LOG_INFO("retained", "boot reason %s, %u records and %u events retained",
+        reasonName(retainedBootReason),
+        min(retained.sampleCount, (uint32_t)RETAINED_SAMPLES),
+        min(retained.eventCount, (uint32_t)RETAINED_EVENTS));
+    events([](const RetainedEvent &entry) {
+        if (entry.kind == RETAINED_EVT_BOOT) {
+            LOG_INFO("retained", "%u boot (%s)", entry.time, reasonName((RebootReason)entry.arg));
+        } else if (entry.kind == RETAINED_EVT_FEED) {
+            LOG_INFO("retained", "%u feed (%s)", entry.time, entry.arg ? "scheduled" : "manual");
+        }
+    });
+
+    event(RETAINED_EVT_BOOT, retainedBootReason, now);
+}
+
+void RetainedLog::sample(const SeriesRecord &record) {
+    portENTER_CRITICAL(&retainedMux);
+    RetainedSample &slot = retained.samples[retained.sampleCount % RETAINED_SAMPLES];
+    slot.record = record;
+    slot.check = RetainedLog_check(&slot.record, sizeof(SeriesRecord));
+    retained.sampleCount++;
+    portEXIT_CRITICAL(&retainedMux);
+}
+
+void RetainedLog::event(RetainedEventKind kind, uint8_t arg, uint32_t time) {
+    RetainedEvent entry = { time, kind, arg, 0 };
+    entry.check = RetainedLog_check(entry);
+
+    portENTER_CRITICAL(&retainedMux);
+    retained.events[retained.eventCount % RETAINED_EVENTS] = entry;
+    retained.eventCount++;
+    portEXIT_CRITICAL(&retainedMux);
+}
+
+void RetainedLog::setReason(RebootReason reason) {
+    retained.reason = reason;
+}
+
+void RetainedLog::restart(RebootReason reason) {
+    setReason(reason);
+    ESP.restart();
+    while (1) {}
+}
+
+size_t RetainedLog::samples(uint32_t from, const std::function<void(const SeriesRecord &)> &callback) {
+    size_t passed = 0;
+    uint32_t last = 0;
+    uint32_t count = retained.sampleCount;
+    uint32_t first = count > RETAINED_SAMPLES ? count - RETAINED_SAMPLES : 0;
+
+    for (uint32_t i = first; i < count; i++) {
+        const RetainedSample &slot = retained.samples[i % RETAINED_SAMPLES];
+        if (slot.check != RetainedLog_check(&slot.record, sizeof(SeriesRecord))) continue;
+        // Out of order means the RTC was set back; keep the store monotonic
+        if (slot.record.time < from || slot.record.time <= last) continue;
+        last = slot.record.time;
+        callback(slot.record);
+        passed++;
+    }
+    return passed;
+}
+
+size_t RetainedLog::events(const std::function<void(const RetainedEvent &)> &callback) {
+    size_t passed = 0;
+    uint32_t count = retained.eventCount;
+    uint32_t first = count > RETAINED_EVENTS ? count - RETAINED_EVENTS : 0;
+
+    for (uint32_t i = first; i < count; i++) {
+        RetainedEvent entry = retained.events[i % RETAINED_EVENTS];
+        if (entry.check != RetainedLog_check(entry)) continue;
+        callback(entry);
+        passed++;
+    }
+    return passed;
+}
+
+RebootReason RetainedLog::bootReason() {
+    return retainedBootReason;
+}
+
+const char *RetainedLog::reasonName(RebootReason reason) {
+    return reason < REBOOT_REASON_COUNT ? REBOOT_REASON_NAMES[reason] : "?";
+}
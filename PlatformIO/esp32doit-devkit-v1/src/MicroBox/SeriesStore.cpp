@@ -0,0 +1,352 @@
+/**
+ *  @file SeriesStore.cpp
+ *  @version 1.0.0
+ *  @brief Append-only sensor time series on LittleFS with segment compaction.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "MicroBox/SeriesStore.h"
+#include "MicroBox/RetainedLog.h"
+#include "MicroBox/Logger.h"
+
+static const char SEGMENT_MAGIC[4] = { 'M', 'B', 'T', 'S' };
+
+bool SeriesStoreClass::begin() {
+    // Already mounted by the web server is fine; never format, the web assets live here too
+    if (!LittleFS.begin(false)) {
+        LOG_ERROR("series", "LittleFS not available");
+        return false;
+    }
+    if (!LittleFS.exists(SERIES_DIR)) LittleFS.mkdir(SERIES_DIR);
+
+    // Rebuild the segment index from the directory
+    uint32_t start = micros();
+    File dir = LittleFS.open(SERIES_DIR);
+    File file = dir.openNextFile();
+    while (file) {
+        if (!file.isDirectory()) this->__indexFile__(file);
+        file.close();
+        file = dir.openNextFile();
+    }
+    dir.close();
+
+    // Files beyond the segment limits (e.g. after lowering them), not removed while listing
+    for (uint8_t i = 0; i < this->__staleCount__; i++) LittleFS.remove(this->__stale__[i]);
+    this->__staleCount__ = 0;
+    this->__rebuildMicros__ = micros() - start;
+
+    LOG_INFO("series", "%u raw + %u compacted segments, index rebuilt in %u us",
+        this->__raw__.size, this->__compacted__.size, this->__rebuildMicros__);
+
+    // Records that were still queued in RAM when the board restarted
+    SeriesRecord batch[SERIES_BATCH_RECORDS];
+    size_t batchLen = 0;
+    uint32_t stored = this->__lastTime__();
+    this->__restored__ = RetainedLog::samples(stored + 1, [&](const SeriesRecord &record) {
+        batch[batchLen++] = record;
+        if (batchLen == SERIES_BATCH_RECORDS) {
+            this->__append__(this->__raw__, batch, batchLen);
+            batchLen = 0;
+        }
+    });
+    if (batchLen > 0) this->__append__(this->__raw__, batch, batchLen);
+    this->__records__ += this->__restored__;
+    if (this->__restored__ > 0) {
+        LOG_INFO("series", "%u records restored from RTC memory", this->__restored__);
+    }
+
+    // Lowest priority: flash writes wait until nothing else has work
+    xTaskCreateUniversal(SeriesStoreClass::__task__, "SeriesStore", 4096, this, tskIDLE_PRIORITY, &this->__taskHandle__, PRO_CPU_NUM);
+    return true;
+}
+
+void SeriesStoreClass::add(const SensorSample &sample, uint32_t unixtime) {
+    uint32_t start = unixtime - unixtime % SERIES_RECORD_PERIOD_S;
+
+    // Period over: queue its average
+    if (this->__periodCount__ > 0 && start != this->__periodStart__) {
+        SeriesRecord record;
+        record.time     = this->__periodStart__;
+        record.ph       = this->__periodSum__[HISTORY_PH] / this->__periodCount__;
+        record.ntu      = this->__periodSum__[HISTORY_NTU] / this->__periodCount__;
+        record.capacity = this->__periodSum__[HISTORY_CAPACITY] / this->__periodCount__;
+        record.samples  = this->__periodCount__;
+        this->__periodCount__ = 0;
+        memset(this->__periodSum__, 0, sizeof(this->__periodSum__));
+        RetainedLog::sample(record);
+
+        bool wake = false;
+        portENTER_CRITICAL(&this->__mux__);
+        if (this->__queueLen__ < SERIES_BATCH_RECORDS * 2) {
+            this->__queue__[this->__queueLen__++] = record;
+            wake = this->__queueLen__ >= SERIES_BATCH_RECORDS;
+        } else {
+            this->__dropped__++;
+        }
+        portEXIT_CRITICAL(&this->__mux__);
+
+        if (wake && this->__taskHandle__ != NULL) xTaskNotifyGive(this->__taskHandle__);
+    }
+
+    if (this->__periodCount__ == 0) this->__periodStart__ = start;
+    this->__periodSum__[HISTORY_PH]       += SensorHistory::encode(HISTORY_PH, sample.ph);
+    this->__periodSum__[HISTORY_NTU]      += SensorHistory::encode(HISTORY_NTU, sample.ntu);
+    this->__periodSum__[HISTORY_CAPACITY] += SensorHistory::encode(HISTORY_CAPACITY, sample.capacity);
+    this->__periodCount__++;
+}
+
+size_t SeriesStoreClass::replay(uint32_t from, const std::function<void(const SeriesRecord &)> &callback) {
+    size_t replayed = 0;
+    SeriesRecord records[SERIES_BATCH_RECORDS];
+
+    for (SegmentList *list : { &this->__compacted__, &this->__raw__ }) {
+        for (uint8_t i = 0; i < list->size; i++) {
+            const Segment &seg = list->items[i];
+            if (seg.count == 0 || seg.last < from) continue;
+
+            char path[24];
+            __path__(path, list->compacted, seg.seq);
+            // Skip the records of a partly compacted segment that were replayed as averages
+            uint32_t skip = !list->compacted && seg.seq == this->__compactSeq__ ? this->__compactDone__ : 0;
+            File file = LittleFS.open(path, "r");
+            if (!file || !file.seek(sizeof(SegmentHeader) + skip * sizeof(SeriesRecord))) continue;
+
+            size_t got;
+            while ((got = file.read((uint8_t *)records, sizeof(records)) / sizeof(SeriesRecord)) > 0) {
+                for (size_t r = 0; r < got; r++) {
+                    if (records[r].time < from) continue;
+                    callback(records[r]);
+                    replayed++;
+                }
+            }
+            file.close();
+        }
+    }
+    return replayed;
+}
+
+void SeriesStoreClass::__task__(void *pvParameter) {
+    static_cast<SeriesStoreClass *>(pvParameter)->__run__();
+}
+
+void SeriesStoreClass::__run__() {
+    while (1) {
+        // Woken by add() once a batch is full, otherwise sync what is there on the interval
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SERIES_SYNC_INTERVAL_MS));
+        this->__flush__();
+    }
+}
+
+void SeriesStoreClass::__flush__() {
+    SeriesRecord batch[SERIES_BATCH_RECORDS * 2];
+    uint16_t count;
+
+    portENTER_CRITICAL(&this->__mux__);
+    count = this->__queueLen__;
+    memcpy(batch, this->__queue__, count * sizeof(SeriesRecord));
+    this->__queueLen__ = 0;
+    portEXIT_CRITICAL(&this->__mux__);
+    if (count == 0) return;
+
+    uint32_t start = micros();
+    size_t written = this->__append__(this->__raw__, batch, count);
+    this->__records__ += written;
+    this->__dropped__ += count - written;
+    uint32_t elapsed = micros() - start;
+    if (elapsed > this->__worstFlush__) this->__worstFlush__ = elapsed;
+
+    // A failed compaction keeps its raw segment and is retried on the next flush
+    while (this->__raw__.size > this->__raw__.limit && this->__compact__()) {}
+}
+
+size_t SeriesStoreClass::__append__(SegmentList &list, const SeriesRecord *records, size_t count) {
+    size_t done = 0;
+    while (count > 0) {
+        // Start a new segment when there is none or the newest is full
+        bool fresh = list.size == 0 || list.items[list.size - 1].count >= SERIES_SEGMENT_RECORDS;
+        uint32_t seq = fresh ? this->__nextSeq__ : list.items[list.size - 1].seq;
+        char path[24];
+        __path__(path, list.compacted, seq);
+        File file = LittleFS.open(path, fresh ? "w" : "a");
+        if (!file) return done;
+
+        // A new segment is only indexed once its file carries the header
+        if (fresh) {
+            SegmentHeader header = { { 0 }, 1, list.compacted, sizeof(SeriesRecord) };
+            memcpy(header.magic, SEGMENT_MAGIC, sizeof(header.magic));
+            size_t headerLen = file.write((const uint8_t *)&header, sizeof(header));
+            this->__bytesWritten__ += headerLen;
+            if (headerLen != sizeof(header)) {
+                file.close();
+                LittleFS.remove(path);
+                return done;
+            }
+            if (list.size == sizeof(list.items) / sizeof(list.items[0])) this->__dropOldest__(list);
+            list.items[list.size++] = { this->__nextSeq__++, records[0].time, records[0].time, 0 };
+        }
+
+        Segment &seg = list.items[list.size - 1];
+        size_t n = min(count, (size_t)(SERIES_SEGMENT_RECORDS - seg.count));
+        size_t written = file.write((const uint8_t *)records, n * sizeof(SeriesRecord)) / sizeof(SeriesRecord);
+        file.close(); // LittleFS commits on close
+        this->__bytesWritten__ += written * sizeof(SeriesRecord);
+        if (written == 0) return done;
+
+        seg.count += written;
+        seg.last = records[written - 1].time;
+        records += written;
+        count -= written;
+        done += written;
+
+        // Compacted segments have no further stage, the oldest simply goes
+        if (list.compacted && list.size > list.limit) this->__dropOldest__(list);
+    }
+    return done;
+}
+
+bool SeriesStoreClass::__compact__() {
+    const Segment &oldest = this->__raw__.items[0];
+    // Resume after the records an interrupted pass already compacted
+    if (this->__compactSeq__ != oldest.seq) {
+        this->__compactSeq__ = oldest.seq;
+        this->__compactDone__ = 0;
+    }
+    char path[24];
+    __path__(path, false, oldest.seq);
+
+    File file = LittleFS.open(path, "r");
+    if (file && file.seek(sizeof(SegmentHeader) + this->__compactDone__ * sizeof(SeriesRecord))) {
+        SeriesRecord in[SERIES_COMPACT_FACTOR];
+        SeriesRecord out[SERIES_BATCH_RECORDS];
+        uint32_t ends[SERIES_BATCH_RECORDS]; // raw records consumed up to each output record
+        uint32_t consumed = this->__compactDone__;
+        size_t outLen = 0, got;
+
+        do {
+            got = file.read((uint8_t *)in, sizeof(in)) / sizeof(SeriesRecord);
+            consumed += got;
+
+            // Average weighted by the samples behind each record
+            int32_t ph = 0, ntu = 0, capacity = 0;
+            uint32_t samples = 0;
+            for (size_t i = 0; i < got; i++) {
+                ph       += (int32_t)in[i].ph * in[i].samples;
+                ntu      += (int32_t)in[i].ntu * in[i].samples;
+                capacity += (int32_t)in[i].capacity * in[i].samples;
+                samples  += in[i].samples;
+            }
+            if (samples > 0) {
+                SeriesRecord &r = out[outLen];
+                r.time     = in[0].time;
+                r.ph       = ph / (int32_t)samples;
+                r.ntu      = ntu / (int32_t)samples;
+                r.capacity = capacity / (int32_t)samples;
+                r.samples  = samples > UINT16_MAX ? UINT16_MAX : samples;
+                ends[outLen++] = consumed;
+            }
+
+            if (outLen == SERIES_BATCH_RECORDS || (got == 0 && outLen > 0)) {
+                size_t written = this->__append__(this->__compacted__, out, outLen);
+                if (written > 0) this->__compactDone__ = ends[written - 1];
+                if (written < outLen) {
+                    file.close();
+                    return false;
+                }
+                outLen = 0;
+            }
+        } while (got > 0);
+        file.close();
+    }
+
+    // Fully compacted, or unreadable and of no further use
+    this->__dropOldest__(this->__raw__);
+    return true;
+}
+
+uint32_t SeriesStoreClass::__lastTime__() const {
+    for (const SegmentList *list : { &this->__raw__, &this->__compacted__ }) {
+        for (uint8_t i = list->size; i > 0; i--) {
+            if (list->items[i - 1].count > 0) return list->items[i - 1].last;
+        }
+    }
+    return 0;
+}
+
+void SeriesStoreClass::__dropOldest__(SegmentList &list) {
+    if (list.size == 0) return;
+
+    char path[24];
+    __path__(path, list.compacted, list.items[0].seq);
+    LittleFS.remove(path);
+    memmove(&list.items[0], &list.items[1], (list.size - 1) * sizeof(Segment));
+    list.size--;
+}
+
+void SeriesStoreClass::__indexFile__(File &file) {
+    // "r<seq>.bin" or "c<seq>.bin"; older cores report the full path
+    const char *name = strrchr(file.name(), '/');
+    name = name != nullptr ? name + 1 : file.name();
+    if (name[0] != 'r' && name[0] != 'c') return;
+
+    SegmentHeader header;
+    if (file.read((uint8_t *)&header, sizeof(header)) != sizeof(header)) return;
+    if (memcmp(header.magic, SEGMENT_MAGIC, sizeof(header.magic)) != 0 || header.recordSize != sizeof(SeriesRecord)) return;
+
+    Segment seg = { (uint32_t)strtoul(name + 1, nullptr, 10), 0, 0, 0 };
+    // A record cut short by a power loss is ignored
+    seg.count = (file.size() - sizeof(SegmentHeader)) / sizeof(SeriesRecord);
+    if (seg.count > 0) {
+        SeriesRecord record;
+        file.read((uint8_t *)&record, sizeof(record));
+        seg.first = record.time;
+        file.seek(sizeof(SegmentHeader) + (seg.count - 1) * sizeof(SeriesRecord));
+        file.read((uint8_t *)&record, sizeof(record));
+        seg.last = record.time;
+    }
+    if (seg.seq >= this->__nextSeq__) this->__nextSeq__ = seg.seq + 1;
+
+    // Insert sorted by sequence; over capacity the oldest is removed after the scan
+    SegmentList &list = name[0] == 'c' ? this->__compacted__ : this->__raw__;
+    if (list.size == sizeof(list.items) / sizeof(list.items[0])) {
+        Segment stale = seg.seq < list.items[0].seq ? seg : list.items[0];
+        if (this->__staleCount__ < sizeof(this->__stale__) / sizeof(this->__stale__[0])) {
+            __path__(this->__stale__[this->__staleCount__++], list.compacted, stale.seq);
+        }
+        if (stale.seq == seg.seq) return;
+        memmove(&list.items[0], &list.items[1], (list.size - 1) * sizeof(Segment));
+        list.size--;
+    }
+    uint8_t i = list.size;
+    while (i > 0 && list.items[i - 1].seq > seg.seq) {
+        list.items[i] = list.items[i - 1];
+        i--;
+    }
+    list.items[i] = seg;
+    list.size++;
+}
+
+void SeriesStoreClass::__path__(char (&path)[24], bool compacted, uint32_t seq) {
+    snprintf(path, sizeof(path), SERIES_DIR "/%c%u.bin", compacted ? 'c' : 'r', seq);
+}
+
+#if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_SeriesStore)
+SeriesStoreClass SeriesStore;
+#endif
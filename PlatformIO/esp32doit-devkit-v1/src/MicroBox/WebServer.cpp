@@ -18,19 +18,21 @@
 
 #include "MicroBox/WebServer.h"
 #include "MicroBox/ProgramWiFi.h"
+#include "MicroBox/config.h"
+#include "MicroBox/Logger.h"
 
 void WebServerClass::ServerInit() {
+#if !defined(WEB_ASSETS_IN_FLASH)
     // Initialize LittleFS
     while (!LFS.begin()) {
-        Serial.println(F("Failed..."));
-        Serial.println(F("Error initializing LittleFS, please try again..."));
-        Serial.println(F("Done : Error 0x1"));
+        LOG_ERROR("http", "Error initializing LittleFS, please try again... (Error 0x1)");
         delay(150);
     }
+#endif
 
     // Initialize mDNS with the hostname "esp32-delay"
     if (!MDNS.begin("esp32-delay")) {
-        Serial.println(F("Error starting mDNS"));
+        LOG_ERROR("http", "Error starting mDNS");
         return;
     }
     
@@ -58,10 +60,9 @@ void WebServerClass::ServerInit() {
 
     // initializes AsyncWebServer
     this->serverAsync.begin();
-    Serial.println(F("HTTP Started..."));
     this->__LOCALIP__ = ProgramWiFi.__LOCALIPServer__;
-    Serial.printf("http://%s:%d/index\t-> index page\n", this->__LOCALIP__.c_str(), this->__PORT__);
-    Serial.printf("http://%s:%d/recovery\t-> recovery page\n", this->__LOCALIP__.c_str(), this->__PORT__);
+    LOG_INFO("http", "HTTP started, http://%s:%d/index -> index page", this->__LOCALIP__.c_str(), this->__PORT__);
+    LOG_INFO("http", "http://%s:%d/recovery -> recovery page", this->__LOCALIP__.c_str(), this->__PORT__);
 }
 
 void WebServerClass::UpdateOTAloop() {
@@ -70,6 +71,10 @@ void WebServerClass::UpdateOTAloop() {
 }
 
 void WebServerClass::Run_css_js_WebServer() {
+#if defined(WEB_ASSETS_IN_FLASH)
+    // Every asset is compiled into the firmware, no filesystem needed
+    this->__registerFlashAssets__();
+#else
     // Define lists of CSS and JavaScript files to serve
     const std::vector<String> list_css_files = {
         "recovery.css", "config_rtc.css"
@@ -77,9 +82,22 @@ void WebServerClass::Run_css_js_WebServer() {
 
     const std::vector<String> list_js_file = {
         "clock.js", "reboot.js", "switchBlynk.js",
-        "sweetalert.min.js", "date_time_rtc.js"
+        "sweetalert.min.js", "date_time_rtc.js", "telemetry.js"
     };
 
+    // Prefer the gzip assets staged by gzip_assets.py, each file under its own route
+    if (this->__loadAssetManifest__()) {
+        for (size_t i = 0; i < this->assets.size(); i++) {
+            String url = this->assets[i].path.substring(4); // strip "/WEB"
+            this->serverAsync.on(url.c_str(), HTTP_GET, [this, i](AsyncWebServerRequest *req) {
+                if (!this->__admit__(req, ROUTE_ASSET)) return;
+                this->__serveAsset__(req, this->assets[i]);
+            });
+        }
+        return;
+    }
+
+    // Filesystem image built without the gzip stage: serve the plain files
     // Serve each CSS file
     for (const auto fileName : list_css_files) {
         this->serverAsync.serveStatic(
@@ -95,6 +113,52 @@ void WebServerClass::Run_css_js_WebServer() {
             (this->DIRJS + fileName).c_str()
         );
     }
+#endif
+}
+
+bool WebServerClass::__loadAssetManifest__() {
+    if (!lfsIsExists(this->ASSET_MANIFEST)) return false;
+
+    File manifest = openfile(this->ASSET_MANIFEST, LFS_READ);
+    if (!manifest) return false;
+
+    // One "<path> <etag>" line per asset
+    this->assets.clear();
+    while (manifest.available()) {
+        String line = manifest.readStringUntil('\n');
+        int space = line.indexOf(' ');
+        if (space <= 0) continue;
+
+        WebAsset asset;
+        asset.path = line.substring(0, space);
+        asset.etag = line.substring(space + 1);
+        asset.etag.trim();
+        this->assets.push_back(asset);
+    }
+    manifest.close();
+    return !this->assets.empty();
+}
+
+void WebServerClass::__serveAsset__(AsyncWebServerRequest *req, const WebAsset &asset) {
+    AsyncWebServerResponse *res;
+
+    if (req->hasHeader("If-None-Match") && req->getHeader("If-None-Match")->value() == asset.etag) {
+        // Browser copy is current, send headers only
+        res = req->beginResponse(304);
+    }
+    else {
+        File content = openfile(asset.path + ".gz", LFS_READ);
+        if (!content) {
+            req->send(404, TEXTPLAIN, "Not found");
+            return;
+        }
+        // A ".gz" file served under the plain path gets "Content-Encoding: gzip"
+        res = req->beginResponse(content, asset.path);
+    }
+
+    res->addHeader("ETag", asset.etag);
+    res->addHeader("Cache-Control", WEB_ASSET_CACHE_CONTROL);
+    req->send(res);
 }
 
 #if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_WebServer)
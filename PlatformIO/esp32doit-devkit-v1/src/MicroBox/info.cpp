@@ -24,6 +24,13 @@
  */
 
 #include "MicroBox/info.h"
+#include "MicroBox/FeederSys.h"
+#include "MicroBox/SysEvents.h"
+#include "MicroBox/ConfigStore.hpp"
+#include "MicroBox/WebServer.h"
+#include "MicroBox/SeriesStore.h"
+#include "MicroBox/RetainedLog.h"
+#include "MicroBox/Logger.h"
 
 // Constants for periodic logging
 unsigned long lastHeapMemoryLogTime = 0;         // Timestamp for the last memory log
@@ -69,13 +76,7 @@ void Info::calculateCpuUsage() {
 
 void Info::logInitialHeapMemoryState() {
     // Log the initial heap memory state
-    Serial.println();
-    Serial.print(F("Total Heap\t: "));
-    Serial.print(totalHeapMemory, 2);
-    Serial.println(F(" KB"));
-    Serial.print(F("Free Heap\t: "));
-    Serial.print(ESP.getFreeHeap() / 1024.0, 2); // Convert bytes to KB
-    Serial.println(F(" KB"));
+    LOG_INFO("mem", "Total Heap : %.2f KB, Free Heap : %.2f KB", totalHeapMemory, ESP.getFreeHeap() / 1024.0); // Convert bytes to KB
 }
 
 void Info::updateLogCpuRamUsage() {
@@ -88,32 +89,32 @@ void Info::updateLogCpuRamUsage() {
         // Update memory metrics
         freeHeapMemory = ESP.getFreeHeap() / 1024.0; // Convert bytes to KB
         
-        // Log CPU usage and memory statistics
-        Serial.println();
-        Serial.println(F("**** CPU Usage ****"));
-        Serial.print(F("CPU Speed Core 0\t: "));
-        Serial.print(ESP.getCpuFreqMHz());
-        Serial.println(F(" MHz"));
-        Serial.print(F("CPU Usage Core 0\t: "));
-        Serial.print(cpuUsageCore0, 2);  // Print CPU usage percentage for Core 0
-        Serial.println(F(" %"));
-        Serial.print(F("CPU Speed Core 1\t: "));
-        Serial.print(ESP.getCpuFreqMHz());
-        Serial.println(F(" MHz"));
-        Serial.print(F("CPU Usage Core 1\t: "));
-        Serial.print(cpuUsageCore1, 2);  // Print CPU usage percentage for Core 1
-        Serial.println(F(" %"));
-        Serial.println();
-        Serial.println(F("**** Memory Usage ****"));
-        Serial.print(F("Total Heap\t: "));
-        Serial.print(totalHeapMemory);
-        Serial.println(F(" KB"));
-        Serial.print(F("Free Heap\t: "));
-        Serial.print(freeHeapMemory, 2);  // Print free heap memory
-        Serial.println(F(" KB"));
-        Serial.print(F("Used Heap\t: "));
-        Serial.print(totalHeapMemory - freeHeapMemory, 2);  // Calculate used heap memory
-        Serial.println(F(" KB"));
-        Serial.println("\n");
+        // Log CPU usage and memory statistics, one queued record per section
+        LOG_INFO("cpu", "core 0 %.2f %%, core 1 %.2f %% at %u MHz", cpuUsageCore0, cpuUsageCore1, ESP.getCpuFreqMHz());
+        LOG_INFO("mem", "heap total %.2f KB, free %.2f KB, used %.2f KB",
+            totalHeapMemory, freeHeapMemory, totalHeapMemory - freeHeapMemory);
+        LOG_INFO("feeder", "worst loop time %u us", FeederSys_worstLoopTime());
+        LOG_INFO("config", "EEPROM commits %u, sector erases %u, slot %u seq %u, load %u us, commit %u us (worst %u us)",
+            ConfigStore::commits(), ConfigStore::sectorErases(), ConfigStore::activeSlot(), ConfigStore::sequence(),
+            ConfigStore::loadMicros(), ConfigStore::commitMicros(), ConfigStore::worstCommitMicros());
+        LOG_INFO("ws", "frames sent %u, dropped %u, clients %u, evictions %u",
+            WebServer.wsFramesSent(), WebServer.wsFramesDropped(), WebServer.wsClients(), WebServer.wsEvictions());
+        LOG_INFO("series", "records %u (%.3f/s), dropped %u, restored %u, write ampl. %.3f",
+            SeriesStore.records(), SeriesStore.records() / (millis() / 1000.0f), SeriesStore.dropped(),
+            SeriesStore.restored(), SeriesStore.writeAmplification());
+        LOG_INFO("series", "worst flush %u us, index rebuild %u us, boot reason %s",
+            SeriesStore.worstFlushMicros(), SeriesStore.rebuildMicros(),
+            RetainedLog::reasonName(RetainedLog::bootReason()));
+        for (uint8_t r = 0; r < ROUTE_COUNT; r++) {
+            RouteStats stats = WebServer.routeStats((WebRoute)r);
+            if (stats.hits == 0 && stats.rejects == 0) continue;
+            LOG_INFO("http", "%-16s: %u hits / %u rejected", WebServerClass::routeName((WebRoute)r), stats.hits, stats.rejects);
+        }
+        LOG_INFO("json", "pool exhausted %u, in use %u", ResponsePool::exhausted(), ResponsePool::inUse());
+        LOG_INFO("wakeup", "per second: sensor %.1f, network %.1f, system %.1f",
+            SysEvents::takeWakeups(SYS_TASK_SENSOR) * 1000.0 / heapMemoryLogInterval,
+            SysEvents::takeWakeups(SYS_TASK_NETWORK) * 1000.0 / heapMemoryLogInterval,
+            SysEvents::takeWakeups(SYS_TASK_SYSTEM) * 1000.0 / heapMemoryLogInterval);
+        LOG_INFO("log", "records %u, dropped %u", Logger.written(), Logger.dropped());
     }
 }
@@ -5,12 +5,18 @@
 // Includes MicroBox Headers
 #include "MicroBox/BootButton.h"
 #include "MicroBox/MyEEPROM.hpp"
+#include "MicroBox/ConfigStore.hpp"
 #include "MicroBox/SysHandlers.h"
 #include "MicroBox/ProgramWiFi.h"
 #include "MicroBox/BlynkProgram.h"
 #include "MicroBox/FeederSys.h"
 #include "MicroBox/WebServer.h"
 #include "MicroBox/info.h"
+#include "MicroBox/ADCSampler.h"
+#include "MicroBox/SysEvents.h"
+#include "MicroBox/SeriesStore.h"
+#include "MicroBox/RetainedLog.h"
+#include "MicroBox/Logger.h"
 
 #include "MicroBox/LEDBoard.h"
 #include "MicroBox/MyStepper.hpp"
@@ -45,6 +51,41 @@ unsigned long LastTimeReboot = 0; //!< Tracker for the last reboot time
 bool RebootState = false;         //!< Tracks ESP reboot state
 
 float ultrasonic_capacity; //!< Variable to store ultrasonic sensor capacity
+SensorSnapshot SensorData;  //!< Latest consistent sample set shared with the other tasks
+SensorHistory History;      //!< Raw, 1-minute and 1-hour sensor history
+
+/**
+ * @brief Receives each ultrasonic measurement and updates the capacity.
+ * @param distance Measured distance in centimeters.
+ * @param valid `false` if the echo timed out; the last capacity is kept.
+ */
+void onUltrasonicEcho(float distance, bool valid) {
+    if (!valid) return;
+
+    // Map the distance to a percentage representing capacity
+    ultrasonic_capacity = map(distance, EMPTY + 1, FULL, 0, 100);
+    // Ensure ultrasonic_capacity is within the valid range
+    ultrasonic_capacity = (ultrasonic_capacity < 0) ? 0 : (ultrasonic_capacity > 100) ? 100 : ultrasonic_capacity;
+}
+
+/**
+ * @brief Adds one stored series record to the in-RAM history.
+ * @param record Record from SeriesStore or RetainedLog.
+ */
+static void loadHistory(const SeriesRecord &record) {
+    SensorSample sample = {};
+    sample.ph       = SensorHistory::decode(HISTORY_PH, record.ph);
+    sample.ntu      = SensorHistory::decode(HISTORY_NTU, record.ntu);
+    sample.capacity = SensorHistory::decode(HISTORY_CAPACITY, record.capacity);
+    History.add(sample, record.time);
+}
+
+/**
+ * @brief Boot button edge interrupt, wakes vTask3 to read the button.
+ */
+void IRAM_ATTR onBootButtonChange() {
+    SysEvents::setFromISR(SYS_EVT_BUTTON);
+}
 
 /**
  * @brief Setup function for initializing hardware and modules.
@@ -57,14 +98,29 @@ float ultrasonic_capacity; //!< Variable to store ultrasonic sensor capacity
  */
 void MicroBox_Main::setup(unsigned long baud) {
     Serial.begin(baud); //!< Initialize serial communication
+    Logger.begin();     //!< Serial output of the tasks goes through the logger
 
-    // Initialize EEPROM and RTC modules
-    myeeprom_prog.initialize();
+    // Initialize EEPROM (settings) and RTC modules
+    ConfigStore::begin();
     rtcprog.begin(true);
     // rtcprog.manualAdjust(12, 19,2024, 11, 53, 50);
 
     // lfsprog.setupLFS(); //!< Available in Pro Version
 
+    // Records and events kept in RTC memory over a soft reset, before SeriesStore merges them
+    uint32_t now = rtcprog.now().unixtime();
+    RetainedLog::begin(now);
+
+    // Reload the stored series into the in-RAM history before the sensor task adds to it
+    uint32_t from = now - HISTORY_MINUTE_LEN * 60UL;
+    size_t loaded = SeriesStore.begin()
+        ? SeriesStore.replay(from, loadHistory)
+        : RetainedLog::samples(from, loadHistory);
+    LOG_INFO("history", "%u records loaded", loaded);
+
+    // Create the event group before any task can set or wait on it
+    SysEvents::begin();
+
     // Create FreeRTOS tasks
     ThisRTOS *prog = new ThisRTOS;
     xTaskCreateUniversal([](void *param) {
@@ -83,7 +139,7 @@ void MicroBox_Main::setup(unsigned long baud) {
  * @param pvParameter Parameters for the task (not used).
  * @details This task continuously reads sensor data (water turbidity, pH, and ultrasonic sensor)
  *          and runs the feeder system based on sensor readings and predefined logic.
- *          It also prints the sensor values to the serial monitor for debugging and monitoring purposes.
+ *          It also logs the sensor values once per second for debugging and monitoring purposes.
  */
 void ThisRTOS::vTask1(void *pvParameter) {
     (void) pvParameter; // Unused parameter
@@ -91,62 +147,66 @@ void ThisRTOS::vTask1(void *pvParameter) {
     // Initialize sensors and relay
     PHSensor.setup(PIN_PH_SENSOR);
     WaterTurbidity.setup(PIN_WATER_TURBIDITY);
+
+    // Scan both analog sensors continuously; they fall back to analogRead() on failure
+    const uint8_t analogPins[] = {PIN_PH_SENSOR, PIN_WATER_TURBIDITY};
+    ADCSampler.begin(analogPins, sizeof(analogPins));
     ultrasonic.begin();
+    ultrasonic.onEcho(onUltrasonicEcho);
 
+    static_assert(ULTRASONIC_TIMEOUT_US / 1000 < SENSOR_PERIOD_MS, "the echo must complete within one sampling period");
+    TickType_t lastWake = xTaskGetTickCount();
+    ultrasonic.ping();
     while(1) {
+        // Collect the echo of the ping sent before the sleep, long complete by now
+        ultrasonic.update();
+
         // Run water turbidity sensor and update readings
         WaterTurbidity.run();
 
         // Run pH sensor and update readings
         PHSensor.run();
         
-        // Get the distance reading from the ultrasonic sensor
         float distance = ultrasonic.getDistance();
-        // Map the distance to a percentage representing capacity
-        ultrasonic_capacity = map(distance, EMPTY + 1, FULL, 0, 100);
-        // Ensure ultrasonic_capacity is within the valid range
-        ultrasonic_capacity = (ultrasonic_capacity < 0) ? 0 : (ultrasonic_capacity > 100) ? 100 : ultrasonic_capacity;
+
+        // Publish the whole sampling cycle at once for the other tasks
+        SensorSample sample;
+        sample.ph         = PHSensor.PH_value;
+        sample.ph_voltage = PHSensor.voltage;
+        sample.ntu        = WaterTurbidity.NTU_value;
+        sample.ntu_adc    = WaterTurbidity.ADC_value;
+        sample.distance   = distance;
+        sample.capacity   = ultrasonic_capacity;
+        sample.timestamp  = millis();
+        SensorData.publish(sample);
+        uint32_t unixtime = rtcprog.now().unixtime();
+        History.add(sample, unixtime);
+        SeriesStore.add(sample, unixtime);
+        // Wake vTask3 when the relay has to switch or a held feed may start now
+        if (FeederSys_relayWanted(sample.ph, sample.ntu) != FeederSys_relayOn() || FeederSys_awaitingSensor()) {
+            SysEvents::set(SYS_EVT_SENSOR_READY);
+        }
         
         static unsigned long LastTimeMonitor = 0;
         if ((unsigned long) (millis() - LastTimeMonitor) >= 1000L) {
             LastTimeMonitor = millis();
 
             if (WiFi.getMode() == WIFI_AP || WiFi.status() == WL_CONNECTED) {
-                Serial.println(F("**************************************\n"));
-                Serial.print(F("Date: ")); Serial.println(rtcprog.datestr());
-                Serial.print(F("Time: ")); Serial.println(rtcprog.timestr());
-                Serial.println(F("**************************************\n"));
-                Serial.print(F("WiFi Mode: "));
-                Serial.println(WiFi.getMode() == WIFI_STA ? "WIFI_STA" : "WIFI_AP");
-                
-                // Print water turbidity sensor readings
-                Serial.println(F("**************************************\n"));
-                Serial.println(F("Water Turbidity: "));
-                Serial.print(F("ADC Value: "));
-                Serial.println(WaterTurbidity.ADC_value);
-                Serial.print(F("NTU Value: "));
-                Serial.println(WaterTurbidity.NTU_value, 2);
-                
-                // Print pH sensor readings
-                Serial.println(F("**************************************\n"));
-                Serial.println(F("PH Sensor: "));
-                Serial.print(F("Voltage (V): "));
-                Serial.println(PHSensor.voltage);
-                Serial.print(F("PH Value: "));
-                Serial.println(PHSensor.PH_value, 2);
-
-                // Print ultrasonic sensor readings
-                Serial.println(F("**************************************\n"));
-                Serial.println(F("Ultrasonic: "));
-                Serial.print(F("Get distance (cm): "));
-                Serial.println(distance);
-                Serial.print(F("Capacity: "));
-                Serial.println(ultrasonic_capacity);
+                // One queued record; the logger task does the UART writing
+                char date[RTC_DATE_LEN], time[RTC_TIME_LEN];
+                LOG_INFO("sensor", "%s %s %s | NTU %.2f (ADC %u) | pH %.2f (%.2f V) | %.2f cm, %.0f %%",
+                    rtcprog.datestr(date), rtcprog.timestr(time),
+                    WiFi.getMode() == WIFI_STA ? "WIFI_STA" : "WIFI_AP",
+                    WaterTurbidity.NTU_value, WaterTurbidity.ADC_value,
+                    PHSensor.PH_value, PHSensor.voltage,
+                    distance, ultrasonic_capacity);
             }
         }
 
-        // Delay the task for 50 milliseconds to control the task execution frequency
-        vTaskDelay(pdMS_TO_TICKS(100));
+        // Start the next measurement and sleep until the next sampling period; one wakeup per sample
+        ultrasonic.ping();
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(SENSOR_PERIOD_MS));
+        SysEvents::wakeup(SYS_TASK_SENSOR);
     }
 }
 
@@ -162,7 +222,7 @@ void ThisRTOS::vTask2(void *pvParameter) {
     (void) pvParameter; // Unused parameter
 
     // Read WiFi state and initialize
-    bool x_state = myeeprom_prog.read(ADDR_EEPROM_WIFI_MODE);
+    bool x_state = ConfigStore::wifiMode();
 
     // Initialize WiFi program
     ProgramWiFi.setup(
@@ -179,6 +239,8 @@ void ThisRTOS::vTask2(void *pvParameter) {
     WebServer.ServerInit();
 
     while(1) {
+        SysEvents::wakeup(SYS_TASK_NETWORK);
+
         // Run the Blynk update function to keep the Blynk application responsive
         Blynk_run();
 
@@ -187,7 +249,14 @@ void ThisRTOS::vTask2(void *pvParameter) {
             WebServer.UpdateOTAloop();
         }
 
-        vTaskDelay(pdMS_TO_TICKS(100));
+        // Push telemetry to the WebSocket subscribers
+        WebServer.Broadcast();
+
+        // Blynk needs a steady poll; in AP mode only the OTA reboot check and the pushes are left
+        uint32_t period = SYS_IDLE_TIMEOUT_MS;
+        if (WiFi.getMode() == WIFI_STA) period = NET_POLL_MS;
+        else if (WebServer.hasSubscribers()) period = WS_BROADCAST_TICK_MS;
+        vTaskDelay(pdMS_TO_TICKS(period));
     }
 }
 
@@ -209,8 +278,12 @@ void ThisRTOS::vTask3(void *pvParameter) {
     LEDBoard::begin();
     bootbtn.begin();
     mystepper.setSpeed(SPEED_STEPPER);
+    FeederSys_begin();
+    attachInterrupt(digitalPinToInterrupt(BOOTBUTTON), onBootButtonChange, CHANGE);
 
     while(1) {
+        SysEvents::wakeup(SYS_TASK_SYSTEM);
+
         // Update the log with current CPU and RAM usage
         if (WiFi.getMode() == WIFI_AP || WiFi.status() == WL_CONNECTED) info.updateLogCpuRamUsage();
         
@@ -224,7 +297,13 @@ void ThisRTOS::vTask3(void *pvParameter) {
         // Run the feeder system logic
         FeederSys_run();
 
-        vTaskDelay(pdMS_TO_TICKS(100));
+        // Persist settings that changed and have settled
+        ConfigStore::run();
+
+        // Sleep until an event arrives or the feeder / housekeeping needs the next tick
+        uint32_t timeout = FeederSys_nextDeadline();
+        if (timeout > SYS_IDLE_TIMEOUT_MS) timeout = SYS_IDLE_TIMEOUT_MS;
+        SysEvents::wait(SYS_EVT_ALL, pdMS_TO_TICKS(timeout));
     }
 }
 
@@ -7,52 +7,108 @@
 
 #include "MicroBox/WebServer.h"
 
+// Indexed by WebRoute
+static const char *const routeNames[ROUTE_COUNT] = {
+    "/recovery", "/data-server", "/api/history", "/config-rtc", "/save-config-rtc",
+    "/enable-blynk", "/rst-webserver", "assets", "not found"
+};
+
+// Tokens taken per request, out of RATE_LIMIT_BURST. A page load fetches
+// the page, its css/js and data at once, so those stay cheap; routes that
+// write the RTC or restart the board and 404 scans drain the bucket fast.
+static const uint8_t routeCosts[ROUTE_COUNT] = {
+    1, 1, 2, 1, 10,
+    10, 10, 1, 4
+};
+
+// Preformatted, so a rejected request costs no JSON work and no allocation for the body
+static const char tooManyRequests[] PROGMEM = "{\"status\":429,\"msg\":\"Too many requests\"}";
+
+const char *WebServerClass::routeName(WebRoute route) {
+    return routeNames[route];
+}
+
+bool WebServerClass::__admit__(AsyncWebServerRequest *req, WebRoute route) {
+    if (this->limiter.allow(req->client()->remoteIP(), routeCosts[route])) {
+        this->__routeStats__[route].hits++;
+        return true;
+    }
+
+    this->__routeStats__[route].rejects++;
+    AsyncWebServerResponse *res = req->beginResponse_P(429, APPJSON, tooManyRequests);
+    res->addHeader("Retry-After", RATE_LIMIT_RETRY_S);
+    req->send(res);
+    return false;
+}
+
+ArRequestHandlerFunction WebServerClass::__limit__(WebRoute route, ArRequestHandlerFunction handler) {
+    return [this, route, handler](AsyncWebServerRequest *req) {
+        if (this->__admit__(req, route)) handler(req);
+    };
+}
+
 void WebServerClass::Routes() {
     // Setup HTTP GET endpoint for recovery page
-    this->serverAsync.on("/recovery", HTTP_GET,
+    this->serverAsync.on("/recovery", HTTP_GET, this->__limit__(ROUTE_RECOVERY,
         std::bind(
             &WebServerClass::RecoveryPage, this,
             std::placeholders::_1
         )
-    );
+    ));
 
     // Setup HTTP GET endpoint for data server
-    this->serverAsync.on("/data-server", HTTP_GET, 
+    this->serverAsync.on("/data-server", HTTP_GET, this->__limit__(ROUTE_DATA_SERVER,
         std::bind(
             &WebServerClass::DataWebServer, this,
             std::placeholders::_1
         )
-    );
+    ));
+
+    // Setup HTTP GET endpoint for the sensor history
+    this->serverAsync.on("/api/history", HTTP_GET, this->__limit__(ROUTE_HISTORY,
+        std::bind(
+            &WebServerClass::HistoryServer, this,
+            std::placeholders::_1
+        )
+    ));
 
     // Setup HTTP GET endpoint to config rtc module
-    this->serverAsync.on("/config-rtc", HTTP_GET,
+    this->serverAsync.on("/config-rtc", HTTP_GET, this->__limit__(ROUTE_CONFIG_RTC,
         std::bind(
-            &WebServerClass::RTC_Config_Main, this, 
+            &WebServerClass::RTC_Config_Main, this,
             std::placeholders::_1
         )
-    );
+    ));
 
     // Setup HTTP GET endpoint to save config rtc module
-    this->serverAsync.on("/save-config-rtc", HTTP_POST, 
+    this->serverAsync.on("/save-config-rtc", HTTP_POST, this->__limit__(ROUTE_SAVE_RTC,
         std::bind(
             &WebServerClass::Save_RTC_Config, this,
             std::placeholders::_1
         )
-    );
+    ));
 
     // Setup HTTP GET endpoint to enable Blynk
-    this->serverAsync.on("/enable-blynk", HTTP_GET,
+    this->serverAsync.on("/enable-blynk", HTTP_GET, this->__limit__(ROUTE_ENABLE_BLYNK,
         std::bind(
             &WebServerClass::EnableBlynk, this,
             std::placeholders::_1
         )
-    );
+    ));
 
     // Setup HTTP GET endpoint to reboot the system
-    this->serverAsync.on("/rst-webserver", HTTP_GET, 
+    this->serverAsync.on("/rst-webserver", HTTP_GET, this->__limit__(ROUTE_REBOOT,
         std::bind(
             &WebServerClass::RebootSys, this,
             std::placeholders::_1
         )
-    );
+    ));
+
+    // Everything else: JSON 404, rate limited so scans stay cheap
+    this->serverAsync.onNotFound(this->__limit__(ROUTE_NOT_FOUND,
+        std::bind(
+            &WebServerClass::__handleNotFound__, this,
+            std::placeholders::_1
+        )
+    ));
 }
@@ -0,0 +1,257 @@
+/**
+ *  @file WSBroadcast.cpp
+ *  @version 1.0.0
+ *  @brief Server-push telemetry for WebSocket subscribers, serialized once per topic.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "MicroBox/WebServer.h"
+#include "MicroBox/Logger.h"
+
+// Topic names as used in the "subscribe" message and the "event" key
+static const char *const wsTopicNames[WS_TOPIC_COUNT] = {
+    "data_server", "datetime"
+};
+
+void WebServerClass::__subscribe__(AsyncWebSocketClient *client, JsonDocument &doc) {
+    uint8_t topics = 0;
+    for (JsonVariantConst topic : doc["topics"].as<JsonArrayConst>()) {
+        const char *name = topic.as<const char *>();
+        for (uint8_t t = 0; t < WS_TOPIC_COUNT; t++) {
+            if (name != nullptr && strcmp(name, wsTopicNames[t]) == 0) topics |= 1 << t;
+        }
+    }
+
+    // "format": "binary" selects TelemetryFrame (see js/telemetry.js), anything else JSON
+    const char *format = doc["format"] | "json";
+    bool binary = strcmp(format, "binary") == 0;
+
+    uint32_t interval = doc["interval"] | (uint32_t)WS_DEFAULT_INTERVAL_MS;
+    interval = constrain(interval, (uint32_t)WS_MIN_INTERVAL_MS, (uint32_t)WS_MAX_INTERVAL_MS);
+
+    bool stored = false;
+    portENTER_CRITICAL(&this->subscribersMux);
+    // Update the client's slot, or take a free one
+    WSSubscriber *slot = nullptr;
+    for (auto &sub : this->subscribers) {
+        if (sub.id == client->id()) { slot = &sub; break; }
+        if (sub.id == 0 && slot == nullptr) slot = &sub;
+    }
+    if (slot != nullptr) {
+        slot->id = client->id();
+        slot->topics = topics;
+        slot->binary = binary;
+        slot->interval = interval;
+        for (auto &last : slot->lastSent) last = millis() - interval; // first frame on the next tick
+        memcpy(slot->lastDropped, slot->lastSent, sizeof(slot->lastDropped));
+        slot->backlogSince = 0;
+        stored = true;
+    }
+    portEXIT_CRITICAL(&this->subscribersMux);
+
+    if (!stored) {
+        LOG_WARN("ws", "WebSocket subscribers full, ignoring client %u", client->id());
+    }
+}
+
+void WebServerClass::__unsubscribe__(uint32_t id) {
+    portENTER_CRITICAL(&this->subscribersMux);
+    for (auto &sub : this->subscribers) {
+        if (sub.id == id) sub = WSSubscriber{};
+    }
+    portEXIT_CRITICAL(&this->subscribersMux);
+}
+
+bool WebServerClass::__evictClient__(AsyncWebSocketClient *client) {
+    uint32_t id = client->id();
+    portENTER_CRITICAL(&this->subscribersMux);
+    bool evicted = this->__isEvicted__(id);
+    if (!evicted) {
+        // Ids only grow, so the last few evictions are all that can still be pending
+        this->__wsEvicted__[this->__wsEvictedNext__] = id;
+        this->__wsEvictedNext__ = (this->__wsEvictedNext__ + 1) % WS_MAX_CLIENTS;
+        this->__wsEvictions__++;
+    }
+    portEXIT_CRITICAL(&this->subscribersMux);
+    if (evicted) return false;
+
+    this->__unsubscribe__(id);
+    // close() only queues a close frame, which a dead peer never takes, so the client and
+    // its queue would stay. Dropping the TCP connection removes and deletes the client now.
+    client->client()->close(true);
+    return true;
+}
+
+bool WebServerClass::__isEvicted__(uint32_t id) {
+    for (uint32_t past : this->__wsEvicted__) {
+        if (past == id) return true;
+    }
+    return false;
+}
+
+void WebServerClass::__reapClients__() {
+    // Over the limit: evict the oldest clients, usually forgotten tabs
+    for (;;) {
+        AsyncWebSocketClient *oldest = nullptr;
+        size_t connected = 0;
+        portENTER_CRITICAL(&this->subscribersMux);
+        for (AsyncWebSocketClient *client : this->ws.getClients()) {
+            if (client->status() != WS_CONNECTED || this->__isEvicted__(client->id())) continue;
+            if (oldest == nullptr) oldest = client; // the list is in connect order
+            connected++;
+        }
+        portEXIT_CRITICAL(&this->subscribersMux);
+        // Eviction deletes a node of the list, so scan again after each one
+        if (connected <= WS_MAX_CLIENTS || !this->__evictClient__(oldest)) return;
+    }
+}
+
+bool WebServerClass::hasSubscribers() {
+    bool any = false;
+    portENTER_CRITICAL(&this->subscribersMux);
+    for (const auto &sub : this->subscribers) {
+        if (sub.id != 0) { any = true; break; }
+    }
+    portEXIT_CRITICAL(&this->subscribersMux);
+    return any;
+}
+
+AsyncWebSocketMessageBuffer *WebServerClass::__serializeTopic__(WSTopic topic) {
+    WebStatus status;
+    this->__status__(status);
+
+    StaticJsonDocument<RESPONSE_JSON_CAPACITY> doc;
+    doc["event"] = wsTopicNames[topic];
+    this->__getHeapMemory__(doc, status);
+
+    if (topic == WS_TOPIC_DATA_SERVER) {
+        this->__getDataServer__(doc, status);
+    } else {
+        this->__getRTCServer__(doc, status);
+    }
+
+    size_t len = measureJson(doc);
+    AsyncWebSocketMessageBuffer *buffer = this->ws.makeBuffer(len);
+    if (buffer == nullptr || buffer->get() == nullptr) return nullptr;
+
+    serializeJson(doc, (char *)buffer->get(), len + 1);
+    return buffer;
+}
+
+AsyncWebSocketMessageBuffer *WebServerClass::__encodeTopic__(WSTopic topic) {
+    AsyncWebSocketMessageBuffer *buffer = this->ws.makeBuffer(TELEMETRY_FRAME_SIZE);
+    if (buffer == nullptr || buffer->get() == nullptr) return nullptr;
+
+    this->__encodeTelemetry__(buffer->get(), topic);
+    return buffer;
+}
+
+void WebServerClass::Broadcast() {
+    // Work on a copy so the lock is never held while talking to the clients
+    WSSubscriber subs[WS_MAX_SUBSCRIBERS];
+    portENTER_CRITICAL(&this->subscribersMux);
+    memcpy(subs, this->subscribers, sizeof(subs));
+    portEXIT_CRITICAL(&this->subscribersMux);
+
+    uint32_t now = millis();
+    bool madeBuffer = false;
+
+    for (uint8_t t = 0; t < WS_TOPIC_COUNT; t++) {
+        // One shared buffer per topic and format
+        AsyncWebSocketMessageBuffer *buffer = nullptr;
+        AsyncWebSocketMessageBuffer *frame = nullptr;
+
+        for (auto &sub : subs) {
+            if (sub.id == 0 || !(sub.topics & (1 << t))) continue;
+            if ((uint32_t)(now - sub.lastSent[t]) < sub.interval) continue;
+
+            AsyncWebSocketClient *client = this->ws.client(sub.id);
+            if (client == nullptr) {
+                this->__unsubscribe__(sub.id);
+                sub.id = 0;
+                continue;
+            }
+
+            // Slow client: latest wins. Nothing more is queued and the frame stays
+            // due, so the next tick after the queue drains sends the newest data.
+            if (client->queueIsFull() || !client->client()->canSend()) {
+                // One drop per frame that fell due, not one per tick it stays due
+                if ((uint32_t)(now - sub.lastDropped[t]) >= sub.interval) {
+                    this->__wsFramesDropped__++;
+                    sub.lastDropped[t] = now;
+                }
+                if (sub.backlogSince == 0) {
+                    sub.backlogSince = now | 1;
+                } else if ((uint32_t)(now - sub.backlogSince) >= WS_STALE_CLIENT_MS) {
+                    // Still stuck: a dead or suspended tab, free its queue
+                    LOG_WARN("ws", "WebSocket client %u stalled, closing", sub.id);
+                    this->__evictClient__(client);
+                    sub.id = 0;
+                }
+                continue;
+            }
+            sub.backlogSince = 0;
+
+            // Serialize lazily, once per topic and format, and share the buffer.
+            // Out of memory: stop the topic, it stays due for the next tick.
+            if (sub.binary) {
+                if (frame == nullptr) {
+                    madeBuffer = true;
+                    frame = this->__encodeTopic__((WSTopic)t);
+                    if (frame == nullptr) break;
+                    frame->lock();
+                }
+                client->binary(frame);
+            } else {
+                if (buffer == nullptr) {
+                    madeBuffer = true;
+                    buffer = this->__serializeTopic__((WSTopic)t);
+                    if (buffer == nullptr) break;
+                    buffer->lock();
+                }
+                client->text(buffer);
+            }
+            sub.lastSent[t] = now;
+            sub.lastDropped[t] = now;
+            this->__wsFramesSent__++;
+        }
+
+        if (buffer != nullptr) buffer->unlock();
+        if (frame != nullptr) frame->unlock();
+    }
+
+    // Write back the send state of the slots that are still owned by the same client
+    portENTER_CRITICAL(&this->subscribersMux);
+    for (uint8_t i = 0; i < WS_MAX_SUBSCRIBERS; i++) {
+        if (subs[i].id != 0 && this->subscribers[i].id == subs[i].id) {
+            memcpy(this->subscribers[i].lastSent, subs[i].lastSent, sizeof(subs[i].lastSent));
+            memcpy(this->subscribers[i].lastDropped, subs[i].lastDropped, sizeof(subs[i].lastDropped));
+            this->subscribers[i].backlogSince = subs[i].backlogSince;
+        }
+    }
+    portEXIT_CRITICAL(&this->subscribersMux);
+
+    // Free the shared buffers that every client has already sent, and any buffer
+    // whose data could not be allocated (it is already in the server's list)
+    if (madeBuffer) this->ws._cleanBuffers();
+
+    this->__reapClients__();
+}
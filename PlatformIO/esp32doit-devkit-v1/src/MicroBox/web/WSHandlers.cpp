@@ -6,12 +6,13 @@
 */
 
 #include "MicroBox/WebServer.h"
+#include "MicroBox/Logger.h"
 
 /**
  * @brief Handles WebSocket events triggered by the server or client.
  * 
  * This function processes WebSocket events such as receiving data, encountering errors, 
- * or handling client disconnections. For data events, it validates the payload, parses 
+ * or handling client connections and disconnections. For data events, it validates the payload, parses 
  * the JSON structure, and triggers the appropriate event handler.
  * 
  * @param server Pointer to the WebSocket server instance.
@@ -32,7 +33,7 @@ void WebServerClass::onEvent(
         constexpr size_t MAX_MESSAGE_SIZE = 512;
         if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT) {
             if (len > MAX_MESSAGE_SIZE) {
-                Serial.println(F("WebSocket message too large, ignoring..."));
+                LOG_WARN("ws", "WebSocket message too large (%u bytes), ignoring", len);
                 return;
             }
 
@@ -45,13 +46,19 @@ void WebServerClass::onEvent(
             StaticJsonDocument<300> doc;
             DeserializationError err = deserializeJson(doc, message);
             if (err) {
-                Serial.printf("JSON parse error: %s\n", err.c_str());
+                LOG_WARN("ws", "JSON parse error: %s", err.c_str());
                 return;
             }
 
             // Handle WebSocket events based on the "event" key in the JSON
             const char *event = doc["event"];
-            if (strcmp(event, "data_server") == 0) {
+            if (event == nullptr) {
+                return;
+            } else if (strcmp(event, "subscribe") == 0) {
+                this->__subscribe__(client, doc); // Push updates from now on
+            } else if (strcmp(event, "unsubscribe") == 0) {
+                this->__unsubscribe__(client->id());
+            } else if (strcmp(event, "data_server") == 0) {
                 this->handleDataServerWS(client); // Handle "data_server" event
             } else if (strcmp(event, "toggle_check") == 0) {
                 // Add logic for the "toggle_check" event here
@@ -62,12 +69,17 @@ void WebServerClass::onEvent(
                 this->handleRTCServer(client);
             }
         }
+    } else if (type == WS_EVT_CONNECT) {
+        // Ping idle clients so a vanished peer is detected and disconnected
+        client->keepAlivePeriod(WS_KEEPALIVE_S);
+        this->__reapClients__();
     } else if (type == WS_EVT_ERROR) {
         // Log WebSocket error with client ID
-        Serial.printf("WebSocket error: %u\n", client->id());
+        LOG_WARN("ws", "WebSocket error: %u", client->id());
     } else if (type == WS_EVT_DISCONNECT) {
         // Log WebSocket client disconnection
-        Serial.printf("WebSocket disconnected: %u\n", client->id());
+        LOG_INFO("ws", "WebSocket disconnected: %u", client->id());
+        this->__unsubscribe__(client->id());
     }
 }
 
@@ -88,7 +100,7 @@ void WebServerClass::handleWebSocketMessage(void *arg, uint8_t *data, size_t len
     if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT) {
         constexpr size_t MAX_MESSAGE_SIZE = 512;
         if (len > MAX_MESSAGE_SIZE) {
-            Serial.println(F("WebSocket message too large, ignoring..."));
+            LOG_WARN("ws", "WebSocket message too large (%u bytes), ignoring", len);
             return;
         }
 
@@ -98,7 +110,7 @@ void WebServerClass::handleWebSocketMessage(void *arg, uint8_t *data, size_t len
         message[len] = '\0';
 
         // Log the received WebSocket message
-        Serial.printf("Received WebSocket message: %s\n", message);
+        LOG_INFO("ws", "Received WebSocket message: %s", message);
 
         // Send an echo response to all connected clients
         String response = String("Echo: ") + message;
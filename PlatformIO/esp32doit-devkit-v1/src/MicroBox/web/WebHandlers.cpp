@@ -0,0 +1,155 @@
+/**
+ *  @file WebHandlers.cpp
+ *  @version 1.0.0
+ *  @brief Transport-independent logic of the JSON endpoints and the HTML templates.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <string.h>
+#include <stdio.h>
+#include <memory>
+#include "MicroBox/WebHandlers.h"
+
+/**
+ * Renderer of one page request: LOCALIP comes from the exchange, the other
+ * placeholders from WebHandlers::__token__().
+ */
+class WebHandlers::PageRenderer : public TemplateRenderer {
+    public:
+        PageRenderer(WebHandlers &handlers, const char *localIP, Reader reader)
+            : TemplateRenderer(reader), __handlers__(handlers) {
+            // The exchange is gone before the last chunk is rendered
+            snprintf(this->__localIP__, sizeof(this->__localIP__), "%s", localIP);
+        }
+
+    protected:
+        const char *__lookup__(std::string_view name) override {
+            if (name == "LOCALIP") return this->__localIP__;
+            return this->__handlers__.__token__(name);
+        }
+
+    private:
+        WebHandlers &__handlers__;  ///< Source of the other placeholders
+        char __localIP__[40];       ///< Address the client connected to (IPv4 or IPv6)
+};
+
+void WebHandlers::__sendJson__(WebExchange &ex, int code, const JsonDocument &doc) {
+    JsonSink &sink = ex.beginJson(code, measureJson(doc));
+    serializeJson(doc, sink);
+    ex.endJson();
+}
+
+void WebHandlers::__getDataServer__(JsonDocument &doc, const WebStatus &status) {
+    JsonObject data = doc.createNestedObject("data_server");
+    // Non-const char* is copied into the document, the status may go first
+    data["date"]        = (char *)status.date;
+    data["time"]        = (char *)status.time;
+
+    // One consistent sampling cycle from the sensor task
+    JsonObject sensor = data.createNestedObject("sensor");
+    sensor["ph"]        = status.sample.ph;
+    sensor["ntu"]       = status.sample.ntu;
+    sensor["capacity"]  = status.sample.capacity;
+    sensor["timestamp"] = status.sample.timestamp;
+    sensor["sequence"]  = status.sample.sequence;
+}
+
+void WebHandlers::__getHeapMemory__(JsonDocument &doc, const WebStatus &status) {
+    char total[16], free[16];
+    snprintf(total, sizeof(total), "%.2f", status.totalHeap);
+    snprintf(free, sizeof(free), "%.2f", status.freeHeap);
+    doc["heap_memory"]["total_heap"] = total;
+    doc["heap_memory"]["free_heap"]  = free;
+}
+
+void WebHandlers::__getRTCServer__(JsonDocument &doc, const WebStatus &status) {
+    JsonObject _datetime = doc.createNestedObject("datetime");
+    _datetime["date"]    = (char *)status.date;
+    _datetime["time"]    = (char *)status.time;
+    _datetime["iso8601"] = (char *)status.iso8601;
+}
+
+size_t WebHandlers::__encodeTelemetry__(uint8_t *out, uint8_t topic) {
+    WebStatus status;
+    this->__status__(status);
+    return TelemetryFrame::encode(
+        out, topic, status.sample, status.unixtime, status.totalHeap, status.freeHeap
+    );
+}
+
+void WebHandlers::__dataServer__(WebExchange &ex) {
+    // Clients that ask for it get the compact binary frame instead of JSON
+    const char *accept = ex.header("Accept");
+    if (accept != nullptr && strstr(accept, TELEMETRY_MIME) != nullptr) {
+        uint8_t frame[TELEMETRY_FRAME_SIZE];
+        size_t len = this->__encodeTelemetry__(frame, TELEMETRY_TOPIC_HTTP);
+        ex.send(200, TELEMETRY_MIME, frame, len);
+        return;
+    }
+
+    WebStatus status;
+    this->__status__(status);
+
+    StaticJsonDocument<RESPONSE_JSON_CAPACITY> doc;
+    doc["status"] = 200;
+    this->__getHeapMemory__(doc, status);
+    this->__getDataServer__(doc, status);
+    this->__sendJson__(ex, 200, doc);
+}
+
+void WebHandlers::__rtcServer__(WebExchange &ex) {
+    WebStatus status;
+    this->__status__(status);
+
+    StaticJsonDocument<256> doc;
+    uint16_t statusCode = 200;
+
+    doc["status"] = statusCode;
+    this->__getRTCServer__(doc, status);
+    this->__sendJson__(ex, statusCode, doc);
+}
+
+void WebHandlers::__notFound__(WebExchange &ex) {
+    StaticJsonDocument<RESPONSE_JSON_CAPACITY> doc;
+    uint16_t codeRes = 404;
+
+    doc["status"] = codeRes;
+    doc["msg"] = "File not found";
+    doc["uri"] = ex.url();
+    doc["method"] = ex.isGet() ? "GET" : "POST";
+    doc["args_count"] = ex.args();
+
+    // Echo only the first few arguments, a scanner gets a short answer
+    JsonObject args = doc.createNestedObject("args");
+    for (size_t i = 0; i < ex.args() && i < NOT_FOUND_MAX_ARGS; i++) {
+        args[ex.argName(i)] = ex.arg(i);
+    }
+
+    this->__sendJson__(ex, codeRes, doc);
+}
+
+void WebHandlers::__page__(WebExchange &ex, TemplateRenderer::Reader reader) {
+    // Owned by the filler, which the transport keeps until the last chunk is sent
+    std::shared_ptr<PageRenderer> renderer = std::make_shared<PageRenderer>(*this, ex.localIP(), reader);
+    ex.sendChunked(200, TEXTHTML, [renderer](uint8_t *buf, size_t maxLen) {
+        return renderer->fill(buf, maxLen);
+    });
+}
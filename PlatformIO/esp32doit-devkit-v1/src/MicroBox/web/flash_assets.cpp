@@ -0,0 +1,84 @@
+/**
+ *  @file flash_assets.cpp
+ *  @version 1.0.0
+ *  @brief Web assets compiled into the firmware (WEB_ASSETS_IN_FLASH build mode).
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "MicroBox/WebServer.h"
+#include "MicroBox/config.h"
+
+#if defined(WEB_ASSETS_IN_FLASH)
+#include "WebAssets.h"
+
+// Find an asset by its LittleFS-style path
+static const FlashAsset *findFlashAsset(const String &path) {
+    for (size_t i = 0; i < FlashAssetCount; i++) {
+        if (path == FlashAssets[i].path) return &FlashAssets[i];
+    }
+    return nullptr;
+}
+
+void WebServerClass::__registerFlashAssets__() {
+    for (size_t i = 0; i < FlashAssetCount; i++) {
+        const FlashAsset &asset = FlashAssets[i];
+        if (!asset.gzip) continue; // html pages go through __sendTemplate__
+
+        // "/WEB/js/clock.js" -> "/js/clock.js"
+        this->serverAsync.on(asset.path + 4, HTTP_GET, [this, &asset](AsyncWebServerRequest *req) {
+            if (!this->__admit__(req, ROUTE_ASSET)) return;
+            this->__serveFlashAsset__(req, asset);
+        });
+    }
+}
+
+bool WebServerClass::__sendFlashPage__(WebExchange &ex, const String &path) {
+    const FlashAsset *page = findFlashAsset(path);
+    if (page == nullptr) return false;
+
+    size_t pos = 0;
+    this->__page__(ex, [page, pos](uint8_t *buf, size_t len) mutable {
+        size_t n = min(len, (size_t)page->length - pos);
+        memcpy_P(buf, page->data + pos, n);
+        pos += n;
+        return n;
+    });
+    return true;
+}
+
+void WebServerClass::__serveFlashAsset__(AsyncWebServerRequest *req, const FlashAsset &asset) {
+    AsyncWebServerResponse *res;
+
+    if (req->hasHeader("If-None-Match") && req->getHeader("If-None-Match")->value() == asset.etag) {
+        // Browser copy is current, send headers only
+        res = req->beginResponse(304);
+    }
+    else {
+        res = req->beginResponse_P(200, asset.mime, asset.data, asset.length);
+        if (asset.gzip) res->addHeader("Content-Encoding", "gzip");
+    }
+
+    res->addHeader("ETag", asset.etag);
+    res->addHeader("Cache-Control", WEB_ASSET_CACHE_CONTROL);
+    req->send(res);
+}
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ *  @file history_server.cpp
+ *  @version 1.0.0
+ *  @brief Range queries on the sensor history, streamed as chunked JSON.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <ArduinoJson.h>
+#include "MicroBox/WebServer.h"
+#include "MicroBox/externprog.h"
+
+// Names as used in the query string, indexed by HistoryMetric / HistoryRes
+static const char *const historyMetricNames[HISTORY_METRIC_COUNT] = { "ph", "ntu", "capacity" };
+static const char *const historyResNames[HISTORY_RES_COUNT] = { "raw", "1m", "1h" };
+
+template <size_t N>
+static int8_t __lookup__(const char *const (&names)[N], const String &name) {
+    for (uint8_t i = 0; i < N; i++) {
+        if (name == names[i]) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Cursor of one streamed history query, owned by the chunk callback.
+ * 
+ * The JSON is produced one line at a time into `line`; the callback copies
+ * as much of it as fits into each chunk, so nothing bigger than one point
+ * is ever materialized.
+ */
+struct HistoryQuery {
+    HistoryRes res;
+    HistoryMetric metric;
+    uint32_t from;
+    uint32_t to;
+    uint32_t cursor;
+    uint8_t state;          // 0 header, 1 points, 2 footer, 3 done
+    bool first;
+    char line[96];
+    uint8_t lineLen;
+    uint8_t linePos;
+
+    // Produce the next line, return false when the response is complete
+    bool next() {
+        HistoryPoint p;
+        int len = 0;
+        switch (state) {
+            case 0:
+                len = snprintf(line, sizeof(line), "{\"metric\":\"%s\",\"res\":\"%s\",\"from\":%u,\"to\":%u,\"points\":[",
+                    historyMetricNames[metric], historyResNames[res], from, to);
+                state = 1;
+                break;
+            case 1:
+                // A point before `from` means the history restarted on an RTC step back
+                if (History.read(res, metric, cursor, p) && p.time >= from && p.time <= to) {
+                    const char *sep = first ? "" : ",";
+                    if (res == HISTORY_RAW) {
+                        len = snprintf(line, sizeof(line), "%s[%u,%.2f]", sep, p.time, p.avg);
+                    } else {
+                        len = snprintf(line, sizeof(line), "%s[%u,%.2f,%.2f,%.2f]", sep, p.time, p.min, p.max, p.avg);
+                    }
+                    first = false;
+                    break;
+                }
+                state = 2;
+                // fall through
+            case 2:
+                len = snprintf(line, sizeof(line), "]}");
+                state = 3;
+                break;
+            default:
+                return false;
+        }
+        lineLen = len;
+        linePos = 0;
+        return true;
+    }
+
+    size_t fill(uint8_t *buffer, size_t maxLen) {
+        size_t written = 0;
+        while (written < maxLen) {
+            if (linePos == lineLen && !next()) break;
+            size_t n = min((size_t)(lineLen - linePos), maxLen - written);
+            memcpy(buffer + written, line + linePos, n);
+            linePos += n;
+            written += n;
+        }
+        return written;
+    }
+};
+
+void WebServerClass::HistoryServer(AsyncWebServerRequest *req) {
+    int8_t metric = __lookup__(historyMetricNames, req->hasArg("metric") ? req->arg("metric") : "ph");
+    int8_t res = __lookup__(historyResNames, req->hasArg("res") ? req->arg("res") : "1m");
+
+    if (metric < 0 || res < 0) {
+        AsyncWebExchange ex(req);
+        StaticJsonDocument<128> doc;
+        doc["status"] = 400;
+        doc["error"] = metric < 0 ? "metric must be ph, ntu or capacity" : "res must be raw, 1m or 1h";
+        this->__sendJson__(ex, 400, doc);
+        return;
+    }
+
+    HistoryQuery query = {};
+    query.res = (HistoryRes)res;
+    query.metric = (HistoryMetric)metric;
+    query.from = req->hasArg("from") ? strtoul(req->arg("from").c_str(), nullptr, 10) : 0;
+    query.to = req->hasArg("to") ? strtoul(req->arg("to").c_str(), nullptr, 10) : UINT32_MAX;
+    query.cursor = History.lowerBound(query.res, query.from);
+    query.first = true;
+
+    // The query state lives in the callback; the rings are read one point per call
+    AsyncWebServerResponse *response = req->beginChunkedResponse(APPJSON,
+        [query](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+            return query.fill(buffer, maxLen);
+        }
+    );
+    req->send(response);
+}
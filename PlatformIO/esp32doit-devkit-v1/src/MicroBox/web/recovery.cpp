@@ -6,48 +6,7 @@
  */
 
 #include "MicroBox/WebServer.h"
-#include "MicroBox/ProgramWiFi.h"
 
 void WebServerClass::RecoveryPage(AsyncWebServerRequest *req) {
-    String page = this->file_buffer(this->DIRHTML + "recovery.html");
-    if (page == "") {
-        this->__handleNotFound__(req);
-        return;
-    }
-
-    // get IP Address
-    this->__LOCALIP__ = req->client()->localIP().toString().c_str();
-
-    const String placeholders[] = {
-        "%LOCALIP%",
-        "%VERSIONPROJECT%", "%HWVERSION%", "%SWVERSION%",
-        "%BUILDDATE%", "%FIRMWAREREGION%",
-        "%LOCALIP%", "%SSIDAP%", "%PASSWORDAP%", "%SSIDSTA%",
-        "%PASSWORDSTA%",
-        "%LOCALIP%", "%LOCALIP%"
-    };
-
-    const String tags_html[] = {
-        this->__LOCALIP__.c_str(),
-        this->projectVersion.c_str(),
-        this->hardwareVersion.c_str(),
-        this->softwareVersion.c_str(),
-        this->buildDate.c_str(),
-        this->regionName.c_str(),
-        
-        this->__LOCALIP__.c_str(),
-        ProgramWiFi.__SSID_AP__.c_str(),
-        ProgramWiFi.__PASSWORD_AP__.c_str(),
-        ProgramWiFi.__SSID_STA__.c_str(),
-        ProgramWiFi.__PASSWORD_STA__.c_str(),
-
-        this->__LOCALIP__.c_str(), this->__LOCALIP__.c_str()
-    };
-
-    // Replace page
-    for (size_t i = 0; i < std::size_t(tags_html); ++i) {
-        page.replace(placeholders[i], tags_html[i]);
-    }
-
-    req->send(200, TEXTHTML, page);
+    this->__sendTemplate__(req, this->DIRHTML + "recovery.html");
 }
@@ -7,44 +7,13 @@
 
 #include "MicroBox/WebServer.h"
 #include "MicroBox/externprog.h"
+#include "MicroBox/FeederSys.h"
 
 void WebServerClass::RTC_Config_Main(AsyncWebServerRequest *req) {
-    // read file html
-    String page = this->file_buffer(this->DIRHTML + "config_rtc.html");
-    if (page == "") {
-        this->__handleNotFound__(req);
-        return;
-    }
-
-    // get ip address
-    this->__LOCALIP__ = req->client()->localIP().toString();
-
-    const std::string placeholders[] = {
-        "%VERSIONPROJECT%",
-        "%LOCALIP%"
-    };
-
-    const std::string tags_html[] = {
-        this->projectVersion.c_str(),
-        this->__LOCALIP__.c_str()
-    };
-
-    // replace page
-    for (size_t i = 0; i < std::size(tags_html); ++i) {
-        page.replace(placeholders[i].c_str(), tags_html[i].c_str());
-    }
-
-    req->send_P(200, TEXTHTML, page.c_str());
+    this->__sendTemplate__(req, this->DIRHTML + "config_rtc.html");
 }
 
 void WebServerClass::Save_RTC_Config(AsyncWebServerRequest *req) {
-    // read file html
-    String page = this->file_buffer(this->DIRHTML + "save_config_rtc.html");
-    if (page == "") {
-        this->__handleNotFound__(req);
-        return;
-    }
-
     int __MONTH__, __DAY__, __YEAR__;
     int __HOUR__, __MINUTE__, __SECOND__;
 
@@ -69,25 +38,8 @@ void WebServerClass::Save_RTC_Config(AsyncWebServerRequest *req) {
             __MONTH__, __DAY__, __YEAR__,
             __HOUR__, __MINUTE__, __SECOND__
         );
+        FeederSys_rearmSchedule();
     }
 
-    // get ip address
-    this->__LOCALIP__ = req->client()->localIP().toString();
-
-    const std::string placeholders[] = {
-        "%VERSIONPROJECT%",
-        "%LOCALIP%"
-    };
-
-    const std::string tags_html[] = {
-        this->projectVersion.c_str(),
-        this->__LOCALIP__.c_str()
-    };
-
-    // replace page
-    for (size_t i = 0; i < std::size(tags_html); ++i) {
-        page.replace(placeholders[i].c_str(), tags_html[i].c_str());
-    }
-
-    req->send_P(200, TEXTHTML, page.c_str());
+    this->__sendTemplate__(req, this->DIRHTML + "save_config_rtc.html");
 }
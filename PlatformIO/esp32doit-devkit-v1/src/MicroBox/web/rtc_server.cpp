@@ -10,33 +10,18 @@
 #include "MicroBox/externprog.h"
 #include "MicroBox/info.h"
 
-void WebServerClass::__getRTCServer__(StaticJsonDocument<200> &doc) {
-    JsonObject _datetime = doc.createNestedObject("datetime");
-    _datetime["date"] = rtcprog.datestr();
-    _datetime["time"] = rtcprog.timestr();
-}
-
 void WebServerClass::RTCServer(AsyncWebServerRequest *req) {
-    StaticJsonDocument<200> doc;
-    String response = "";
-    uint16_t statusCode = 200;
-
-    doc["status"] = statusCode;
-    this->__getRTCServer__(doc);
-
-    serializeJson(doc, response);
-    req->send_P(statusCode, APPJSON, response.c_str());
+    AsyncWebExchange ex(req);
+    this->__rtcServer__(ex);
 }
 
 void WebServerClass::handleRTCServer(AsyncWebSocketClient *client) {
-    StaticJsonDocument<200> response;
-    response["event"] = "datetime";
-    response["heap_memory"]["total_heap"] = String(totalHeapMemory, 2);
-    response["heap_memory"]["free_heap"] = String(freeHeapMemory, 2);
-    this->__getRTCServer__(response);
+    WebStatus status;
+    this->__status__(status);
 
-    String jsonResponse = "";
-    serializeJson(response, jsonResponse);
-    response.clear();
-    client->text(jsonResponse.c_str());
+    StaticJsonDocument<256> response;
+    response["event"] = "datetime";
+    this->__getHeapMemory__(response, status);
+    this->__getRTCServer__(response, status);
+    this->__sendJsonWS__(client, response);
 }
@@ -7,75 +7,99 @@
 
 #include "MicroBox/WebServer.h"
 #include "MicroBox/externprog.h"
+#include "MicroBox/SysEvents.h"
+#include "MicroBox/ConfigStore.hpp"
+#include "MicroBox/RetainedLog.h"
+
+void WebServerClass::__status__(WebStatus &status) {
+    // One consistent sampling cycle from the sensor task
+    status.sample = {};
+    SensorData.read(status.sample);
+
+    rtcprog.datestr(status.date);
+    rtcprog.timestr(status.time);
+    rtcprog.iso8601(status.iso8601);
+    status.unixtime = rtcprog.now().unixtime();
+
+    status.totalHeap = totalHeapMemory;
+    status.freeHeap = freeHeapMemory;
+}
 
-String WebServerClass::file_buffer(String fileName) {
-    this->file = openfile(fileName, LFS_READ);
-    if (!this->file) {
-        return "";
+const char *WebServerClass::__token__(std::string_view name) {
+    // Placeholder lookup table, `%NAME%` in the HTML files
+    struct TemplateToken {
+        const char *name;
+        const char *value;
+    };
+
+    const TemplateToken tokens[] = {
+        { "VERSIONPROJECT", this->projectVersion.c_str() },
+        { "HWVERSION",      this->hardwareVersion.c_str() },
+        { "SWVERSION",      this->softwareVersion.c_str() },
+        { "BUILDDATE",      this->buildDate.c_str() },
+        { "FIRMWAREREGION", this->regionName.c_str() },
+        { "SSIDAP",         ProgramWiFi.__SSID_AP__.c_str() },
+        { "PASSWORDAP",     ProgramWiFi.__PASSWORD_AP__.c_str() },
+        { "SSIDSTA",        ProgramWiFi.__SSID_STA__.c_str() },
+        { "PASSWORDSTA",    ProgramWiFi.__PASSWORD_STA__.c_str() }
+    };
+
+    for (const auto &t : tokens) {
+        if (name == t.name) return t.value;
     }
+    return nullptr;
+}
+
+void WebServerClass::__sendTemplate__(AsyncWebServerRequest *req, const String &path) {
+    AsyncWebExchange ex(req);
 
-    // read file content
-    size_t fileSize = this->file.size();
-    std::unique_ptr<char []> fileBuffer(new char[fileSize + 1]);
-    this->file.readBytes(fileBuffer.get(), fileSize);
-    fileBuffer[fileSize] = '\0';
-    this->file.close();
+#if defined(WEB_ASSETS_IN_FLASH)
+    if (this->__sendFlashPage__(ex, path)) return;
+    this->__notFound__(ex);
+#else
+    if (!lfsIsExists(path)) {
+        this->__notFound__(ex);
+        return;
+    }
 
-    return String(fileBuffer.get());
+    // The page is read chunk by chunk and each placeholder is substituted
+    // as it streams, so the page is never held in RAM; the file closes with
+    // the last copy of the reader
+    File file = LFS.open(path, LFS_READ);
+    this->__page__(ex, [file](uint8_t *buf, size_t len) mutable {
+        return file.read(buf, len);
+    });
+#endif
 }
 
-void WebServerClass::RebootSys(AsyncWebServerRequest *req) {
+void WebServerClass::__restart__(WebExchange &ex, bool enableBlynk) {
     StaticJsonDocument<100> doc;
-    std::string jsonResponse = "";
     uint16_t codeRes = 200;
 
     doc["status"] = codeRes;
-    doc["msg"] = "Server has been restart";
+    doc["msg"] = enableBlynk ? "Enable Blynk, Server has been restart" : "Server has been restart";
+    this->__sendJson__(ex, codeRes, doc);
 
-    serializeJson(doc, jsonResponse);
-    req->send_P(codeRes, APPJSON, jsonResponse.c_str());
+    if (enableBlynk) ConfigStore::setWifiMode(true);
+    RetainedLog::setReason(enableBlynk ? REBOOT_ENABLE_BLYNK : REBOOT_WEB);
 
     LastTimeReboot = millis();
     RebootState = true;
+    SysEvents::set(SYS_EVT_REBOOT);
 }
 
-void WebServerClass::EnableBlynk(AsyncWebServerRequest *req) {
-    StaticJsonDocument<100> doc;
-
-    std::string jsonResponse = "";
-    uint16_t codeRes = 200;
-
-    doc["status"] = codeRes;
-    doc["msg"] = "Enable Blynk, Server has been restart";
-
-    serializeJson(doc, jsonResponse);
-    req->send_P(codeRes, APPJSON, jsonResponse.c_str());
-
-    this->myeeprom.save_wifi_state(true);
-    delay(50);
+void WebServerClass::RebootSys(AsyncWebServerRequest *req) {
+    AsyncWebExchange ex(req);
+    this->__restart__(ex, false);
+}
 
-    LastTimeReboot = millis();
-    RebootState = true;
+void WebServerClass::EnableBlynk(AsyncWebServerRequest *req) {
+    AsyncWebExchange ex(req);
+    this->__restart__(ex, true);
 }
 
 // page 404
 void WebServerClass::__handleNotFound__(AsyncWebServerRequest *req) {
-    StaticJsonDocument<200> doc;
-
-    std::string jsonRes = "";
-    uint16_t codeRes = 404;
-
-    doc["status"] = codeRes;
-    doc["msg"] = "File not found";
-    doc["uri"] = req->url();
-    doc["method"] = req->method() == HTTP_GET ? "GET" : "POST";
-    doc["args_count"] = req->args();
-
-    JsonObject args = doc.createNestedObject("args");
-    for (uint8_t i = 0; i < req->args(); i++) {
-        args[req->argName(i)] = req->arg(i);
-    }
-
-    serializeJson(doc, jsonRes);
-    req->send_P(codeRes, APPJSON, jsonRes.c_str());
+    AsyncWebExchange ex(req);
+    this->__notFound__(ex);
 }
@@ -0,0 +1,93 @@
+/**
+ *  @file AllocCounter.h
+ *  @version 1.0.0
+ *  @brief Heap allocation counter for the native tests and benchmarks.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <new>
+
+/**
+ * Replaces the global allocation functions, so include it from exactly one
+ * source file of a test suite. On glibc malloc/calloc/realloc are hooked,
+ * which also catches `operator new` and anything C code allocates; on other
+ * hosts only `operator new` is counted.
+ */
+
+/**
+ * @struct AllocCount
+ * @brief Allocations since the start of the program.
+ */
+struct AllocCount {
+    size_t calls;   ///< Allocation calls
+    size_t bytes;   ///< Bytes requested
+};
+
+static AllocCount allocTotal = {};
+
+/**
+ * @brief Allocations made since `since` was taken.
+ * @param since An earlier allocCount() result.
+ */
+static inline AllocCount allocCount(const AllocCount &since = {}) {
+    return { allocTotal.calls - since.calls, allocTotal.bytes - since.bytes };
+}
+
+#if defined(__GLIBC__)
+extern "C" {
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t n, size_t size);
+    void *__libc_realloc(void *ptr, size_t size);
+
+    void *malloc(size_t size) {
+        allocTotal.calls++;
+        allocTotal.bytes += size;
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t n, size_t size) {
+        allocTotal.calls++;
+        allocTotal.bytes += n * size;
+        return __libc_calloc(n, size);
+    }
+
+    void *realloc(void *ptr, size_t size) {
+        allocTotal.calls++;
+        allocTotal.bytes += size;
+        return __libc_realloc(ptr, size);
+    }
+}
+#else
+void *operator new(size_t size) {
+    allocTotal.calls++;
+    allocTotal.bytes += size;
+    void *p = malloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+#endif
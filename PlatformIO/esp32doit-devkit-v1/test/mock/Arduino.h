@@ -0,0 +1,150 @@
+/**
+ *  @file Arduino.h
+ *  @version 1.0.0
+ *  @brief Minimal Arduino-ESP32 and FreeRTOS shim for the native tests.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+/**
+ * Only what the modules under test use. Critical sections are no-ops, the
+ * tests are single threaded. A created task is not started: the test runs
+ * one pass of it with MockTask::run(), which returns at the task's next
+ * ulTaskNotifyTake().
+ */
+
+using std::min;
+using std::max;
+
+#define F(text)                     text
+#define RTC_NOINIT_ATTR
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux)     ((void)(mux))
+#define portEXIT_CRITICAL(mux)      ((void)(mux))
+
+typedef void *TaskHandle_t;
+typedef uint32_t TickType_t;
+#define pdTRUE                      1
+#define pdFALSE                     0
+#define pdMS_TO_TICKS(ms)           ((TickType_t)(ms))
+#define tskIDLE_PRIORITY            0
+#define tskNO_AFFINITY              0x7FFFFFFF
+#define PRO_CPU_NUM                 0
+#define APP_CPU_NUM                 1
+
+inline uint32_t micros() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+inline uint32_t millis() {
+    return micros() / 1000;
+}
+
+/**
+ * @struct MockTask
+ * @brief The last task created, run on demand by the test.
+ */
+struct MockTask {
+    struct Yield {};                    ///< Thrown by ulTaskNotifyTake() to leave the task loop
+
+    static inline void (*function)(void *) = nullptr;
+    static inline void *parameter = nullptr;
+    static inline uint32_t notified = 0;    ///< xTaskNotifyGive() calls since the last run
+    static inline bool running = false;
+
+    /**
+     * @brief Run the task until it waits for its next notification.
+     * @return `false` if no task was created.
+     */
+    static bool run() {
+        if (function == nullptr) return false;
+        running = true;
+        try {
+            function(parameter);
+        } catch (const Yield &) {}
+        running = false;
+        return true;
+    }
+};
+
+inline int xTaskCreateUniversal(void (*function)(void *), const char *, uint32_t, void *parameter,
+                                int, TaskHandle_t *handle, int) {
+    MockTask::function = function;
+    MockTask::parameter = parameter;
+    if (handle != nullptr) *handle = (TaskHandle_t)&MockTask::function;
+    return pdTRUE;
+}
+
+inline void xTaskNotifyGive(TaskHandle_t) {
+    MockTask::notified++;
+}
+
+inline uint32_t ulTaskNotifyTake(int, TickType_t) {
+    // First call of a run returns at once, the next one ends the run
+    if (!MockTask::running) throw MockTask::Yield();
+    MockTask::running = false;
+    uint32_t notified = MockTask::notified;
+    MockTask::notified = 0;
+    return notified;
+}
+
+inline void vTaskDelay(TickType_t) {}
+
+/**
+ * @class MockSerial
+ * @brief Serial port that writes to stdout.
+ */
+class MockSerial {
+    public:
+        template <typename... Args>
+        size_t printf(const char *format, Args... args) { return ::printf(format, args...); }
+        size_t print(const char *text) { return fputs(text, stdout) >= 0 ? strlen(text) : 0; }
+        size_t println(const char *text = "") { return ::printf("%s\n", text); }
+        size_t write(const uint8_t *data, size_t length) { return fwrite(data, 1, length, stdout); }
+        size_t write(uint8_t byte) { return fputc(byte, stdout) != EOF; }
+};
+
+/**
+ * @class MockEsp
+ * @brief ESP.restart() ends the test with an error.
+ */
+class MockEsp {
+    public:
+        [[noreturn]] void restart() {
+            fprintf(stderr, "ESP.restart() called\n");
+            abort();
+        }
+};
+
+inline MockSerial Serial;
+inline MockEsp ESP;
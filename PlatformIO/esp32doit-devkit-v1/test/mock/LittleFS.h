@@ -0,0 +1,176 @@
+/**
+ *  @file LittleFS.h
+ *  @version 1.0.0
+ *  @brief LittleFS shim over a host directory for the native tests.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+/**
+ * Paths are mapped below MockFS::root(), a directory in the system temp
+ * folder that clear() empties. failOpens / failWrites make the next opens
+ * or writes fail, to test the error paths; passOpens lets that many opens
+ * succeed first. bytesWritten counts what reached the files.
+ */
+
+/**
+ * @class File
+ * @brief File or directory handle, as returned by LittleFS.open().
+ */
+class File {
+    public:
+        File() {}
+
+        operator bool() const { return this->__file__ != nullptr || this->__dir__ != nullptr; }
+        bool isDirectory() const { return this->__dir__ != nullptr; }
+        const char *path() const { return this->__path__.c_str(); }
+        const char *name() const {
+            size_t slash = this->__path__.rfind('/');
+            return this->__path__.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+        }
+
+        size_t size() const;
+        size_t read(uint8_t *data, size_t length) {
+            return this->__file__ ? fread(data, 1, length, this->__file__.get()) : 0;
+        }
+        size_t write(const uint8_t *data, size_t length);
+        bool seek(uint32_t position) {
+            return this->__file__ && fseek(this->__file__.get(), position, SEEK_SET) == 0;
+        }
+        void close() {
+            this->__file__.reset();
+            this->__dir__.reset();
+        }
+        File openNextFile();
+
+    private:
+        friend class MockFS;
+        std::string __path__;
+        std::shared_ptr<FILE> __file__;
+        std::shared_ptr<std::filesystem::directory_iterator> __dir__;
+};
+
+/**
+ * @class MockFS
+ * @brief The LittleFS object.
+ */
+class MockFS {
+    public:
+        unsigned passOpens = 0;     ///< Opens for writing that succeed before failOpens applies
+        unsigned failOpens = 0;     ///< Next opens for writing that fail
+        unsigned failWrites = 0;    ///< Next writes that write nothing
+        size_t bytesWritten = 0;    ///< Bytes written to files
+
+        static std::filesystem::path root() {
+            return std::filesystem::temp_directory_path() / "microbox-littlefs";
+        }
+
+        /**
+         * @brief Remove every file and reset the counters.
+         */
+        void clear() {
+            std::error_code error;
+            std::filesystem::remove_all(root(), error);
+            std::filesystem::create_directories(root(), error);
+            this->passOpens = this->failOpens = this->failWrites = 0;
+            this->bytesWritten = 0;
+        }
+
+        static std::filesystem::path host(const char *path) {
+            return root() / (path[0] == '/' ? path + 1 : path);
+        }
+
+        bool begin(bool = false) {
+            std::error_code error;
+            std::filesystem::create_directories(root(), error);
+            return !error;
+        }
+        bool exists(const char *path) { return std::filesystem::exists(host(path)); }
+        bool mkdir(const char *path) {
+            std::error_code error;
+            return std::filesystem::create_directory(host(path), error);
+        }
+        bool remove(const char *path) {
+            std::error_code error;
+            return std::filesystem::remove(host(path), error);
+        }
+
+        File open(const char *path, const char *mode = "r") {
+            File file;
+            file.__path__ = path;
+            std::filesystem::path target = host(path);
+            if (std::filesystem::is_directory(target)) {
+                file.__dir__ = std::make_shared<std::filesystem::directory_iterator>(target);
+                return file;
+            }
+            if (mode[0] != 'r' && this->passOpens > 0) {
+                this->passOpens--;
+            } else if (mode[0] != 'r' && this->failOpens > 0) {
+                this->failOpens--;
+                return File();
+            }
+            const char *hostMode = mode[0] == 'a' ? "ab" : mode[0] == 'w' ? "wb" : "rb";
+            FILE *handle = fopen(target.c_str(), hostMode);
+            if (handle != nullptr) file.__file__.reset(handle, fclose);
+            return file;
+        }
+};
+
+inline MockFS LittleFS;
+
+inline size_t File::size() const {
+    std::error_code error;
+    size_t length = std::filesystem::file_size(MockFS::host(this->path()), error);
+    return error ? 0 : length;
+}
+
+inline size_t File::write(const uint8_t *data, size_t length) {
+    if (!this->__file__) return 0;
+    if (LittleFS.failWrites > 0) {
+        LittleFS.failWrites--;
+        return 0;
+    }
+    size_t written = fwrite(data, 1, length, this->__file__.get());
+    fflush(this->__file__.get());
+    LittleFS.bytesWritten += written;
+    return written;
+}
+
+inline File File::openNextFile() {
+    File file;
+    if (!this->__dir__ || *this->__dir__ == std::filesystem::directory_iterator()) return file;
+    const std::filesystem::directory_entry &entry = **this->__dir__;
+    file.__path__ = std::string(this->__path__) + "/" + entry.path().filename().string();
+    if (entry.is_directory()) {
+        file.__dir__ = std::make_shared<std::filesystem::directory_iterator>(entry.path());
+    } else {
+        FILE *handle = fopen(entry.path().c_str(), "rb");
+        if (handle != nullptr) file.__file__.reset(handle, fclose);
+    }
+    ++*this->__dir__;
+    return file;
+}
@@ -0,0 +1,109 @@
+/**
+ *  @file MockPooledExchange.h
+ *  @version 1.0.0
+ *  @brief PooledExchange for the native tests: slots are held until disconnect().
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "MicroBox/PooledExchange.h"
+
+#define MOCK_STREAM_LEN     1024    ///< Largest captured stream (fallback) body (bytes)
+
+/**
+ * @class MockPooledExchange
+ * @brief Runs the real ResponsePool path; the "connection" stays open until disconnect().
+ * 
+ * Like AsyncWebExchange, a pooled body is sent straight from its slot and
+ * the slot is released when the connection goes away. The request is a
+ * bare GET with an optional Accept header.
+ */
+class MockPooledExchange : public PooledExchange {
+    public:
+        MockPooledExchange(const char *url = "/", const char *accept = nullptr) : __url__(url), __accept__(accept) {}
+        ~MockPooledExchange() { this->disconnect(); }
+
+        /**
+         * @brief Close the connection, which gives a pooled body back.
+         */
+        void disconnect() {
+            if (this->slot != nullptr) ResponsePool::release(this->slot);
+            this->slot = nullptr;
+        }
+
+        const char *url() const override { return this->__url__; }
+        bool isGet() const override { return true; }
+        const char *localIP() const override { return "192.168.4.1"; }
+
+        size_t args() const override { return 0; }
+        const char *argName(size_t i) const override { return nullptr; }
+        const char *arg(size_t i) const override { return nullptr; }
+        const char *arg(const char *name) const override { return nullptr; }
+
+        const char *header(const char *name) const override {
+            return strcmp(name, "Accept") == 0 ? this->__accept__ : nullptr;
+        }
+
+        void sendChunked(int code, const char *mime, Filler filler) override {
+            this->code = code;
+            this->mime = mime;
+            uint8_t buf[64];
+            while (filler(buf, sizeof(buf)) > 0) {}
+        }
+
+        // Captured response
+        int code = 0;                   ///< Status code, 0 until a response was sent
+        const char *mime = nullptr;     ///< Content type
+        char *slot = nullptr;           ///< Pool slot holding the body, `nullptr` if streamed
+        const char *body = nullptr;     ///< Body bytes, in the slot or in `stream`
+        size_t length = 0;              ///< Body length
+        char stream[MOCK_STREAM_LEN];   ///< Body of a fallback stream response
+
+    protected:
+        void __sendSlot__(int code, const char *mime, char *slot, size_t len) override {
+            this->code = code;
+            this->mime = mime;
+            this->slot = slot;
+            this->body = slot;
+            this->length = len;
+        }
+
+        JsonSink &__beginStream__(int code, const char *mime, size_t len) override {
+            this->code = code;
+            this->mime = mime;
+            this->__streamSink__ = BufferSink(this->stream, sizeof(this->stream));
+            return this->__streamSink__;
+        }
+
+        void __endStream__() override {
+            this->body = this->stream;
+            this->length = this->__streamSink__.length();
+        }
+
+    private:
+        const char *__url__;            ///< Request path
+        const char *__accept__;         ///< Accept header, `nullptr` if none
+        BufferSink __streamSink__;      ///< Writes into `stream`
+};
@@ -0,0 +1,144 @@
+/**
+ *  @file MockWebExchange.h
+ *  @version 1.0.0
+ *  @brief WebExchange for the native tests: fixed request, captured response.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "MicroBox/WebExchange.h"
+
+#define MOCK_MAX_ARGS       8       ///< Arguments (and headers) a mock request can carry
+#define MOCK_BODY_LEN       8192    ///< Largest captured response body (bytes)
+#define MOCK_CHUNK_LEN      1436    ///< Chunk size asked from sendChunked() fillers, one TCP segment
+
+/**
+ * @class MockWebExchange
+ * @brief Request built by the test, response captured into a fixed buffer.
+ * 
+ * Uses no heap itself, so allocation counts taken around a handler call
+ * belong to the handler.
+ */
+class MockWebExchange : public WebExchange {
+    public:
+        MockWebExchange(const char *url, bool get = true) : __url__(url), __get__(get) {}
+
+        MockWebExchange &addArg(const char *name, const char *value) {
+            if (this->__argCount__ < MOCK_MAX_ARGS) this->__args__[this->__argCount__++] = { name, value };
+            return *this;
+        }
+
+        MockWebExchange &addHeader(const char *name, const char *value) {
+            if (this->__headerCount__ < MOCK_MAX_ARGS) this->__headers__[this->__headerCount__++] = { name, value };
+            return *this;
+        }
+
+        /**
+         * @brief Forget the last response, keep the request.
+         */
+        void reset() {
+            this->code = 0;
+            this->mime = nullptr;
+            this->length = 0;
+            this->declared = 0;
+            this->chunks = 0;
+        }
+
+        const char *url() const override { return this->__url__; }
+        bool isGet() const override { return this->__get__; }
+        const char *localIP() const override { return "192.168.4.1"; }
+
+        size_t args() const override { return this->__argCount__; }
+        const char *argName(size_t i) const override { return this->__args__[i].name; }
+        const char *arg(size_t i) const override { return this->__args__[i].value; }
+        const char *arg(const char *name) const override { return find(this->__args__, this->__argCount__, name); }
+        const char *header(const char *name) const override { return find(this->__headers__, this->__headerCount__, name); }
+
+        JsonSink &beginJson(int code, size_t len) override {
+            this->reset();
+            this->code = code;
+            this->mime = APPJSON;
+            this->declared = len;
+            this->__sink__ = BufferSink(this->body, sizeof(this->body));
+            return this->__sink__;
+        }
+
+        void endJson() override {
+            this->length = this->__sink__.length();
+        }
+
+        void send(int code, const char *mime, const uint8_t *data, size_t len) override {
+            this->reset();
+            this->code = code;
+            this->mime = mime;
+            this->length = len < sizeof(this->body) ? len : sizeof(this->body);
+            memcpy(this->body, data, this->length);
+        }
+
+        void sendChunked(int code, const char *mime, Filler filler) override {
+            this->reset();
+            this->code = code;
+            this->mime = mime;
+
+            // Pull the whole body now, like the server does once the headers are out
+            size_t n;
+            do {
+                size_t room = sizeof(this->body) - this->length;
+                n = filler((uint8_t *)this->body + this->length, room < this->chunkLen ? room : this->chunkLen);
+                this->length += n;
+                if (n > 0) this->chunks++;
+            } while (n > 0);
+        }
+
+        // Captured response
+        int code = 0;                   ///< Status code, 0 until a response was sent
+        const char *mime = nullptr;     ///< Content type
+        char body[MOCK_BODY_LEN];       ///< Body bytes, not terminated
+        size_t length = 0;              ///< Body length
+        size_t declared = 0;            ///< Length announced to beginJson()
+        size_t chunks = 0;              ///< Filler calls that returned data
+        size_t chunkLen = MOCK_CHUNK_LEN; ///< Chunk size asked from fillers
+
+    private:
+        struct Pair {
+            const char *name;
+            const char *value;
+        };
+
+        static const char *find(const Pair *pairs, size_t count, const char *name) {
+            for (size_t i = 0; i < count; i++) {
+                if (strcmp(pairs[i].name, name) == 0) return pairs[i].value;
+            }
+            return nullptr;
+        }
+
+        const char *__url__;            ///< Request path
+        bool __get__;                   ///< GET, otherwise POST
+        Pair __args__[MOCK_MAX_ARGS];   ///< Request arguments
+        size_t __argCount__ = 0;        ///< Used entries of `__args__`
+        Pair __headers__[MOCK_MAX_ARGS]; ///< Request headers
+        size_t __headerCount__ = 0;     ///< Used entries of `__headers__`
+        BufferSink __sink__;            ///< Writes JSON bodies into `body`
+};
@@ -0,0 +1,77 @@
+/**
+ *  @file MockWebHandlers.h
+ *  @version 1.0.0
+ *  @brief WebHandlers with fixed device values for the native tests.
+ *  @author basyair7
+ *  @date 2024
+ * 
+ *  @copyright
+ *  Copyright (C) 2024, basyair7
+ * 
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ * 
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ * 
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <string_view>
+#include "MicroBox/WebHandlers.h"
+
+/**
+ * @class MockWebHandlers
+ * @brief WebHandlers whose device values are a fixture the test can change.
+ */
+class MockWebHandlers : public WebHandlers {
+    public:
+        MockWebHandlers() {
+            this->status.sample = { 7.12f, 2.51f, 12.34f, 1234, 9.8f, 76.5f, 123456, 42 };
+            snprintf(this->status.date, sizeof(this->status.date), "10/17/2026");
+            snprintf(this->status.time, sizeof(this->status.time), "12:34:56 PM");
+            snprintf(this->status.iso8601, sizeof(this->status.iso8601), "2026-10-17T12:34:56");
+            this->status.unixtime = 1792240496;
+            this->status.totalHeap = 301.5f;
+            this->status.freeHeap = 180.25f;
+        }
+
+        WebStatus status;   ///< Values returned by __status__()
+
+    protected:
+        void __status__(WebStatus &out) override { out = this->status; }
+
+        const char *__token__(std::string_view name) override {
+            struct TemplateToken {
+                const char *name;
+                const char *value;
+            };
+
+            static const TemplateToken tokens[] = {
+                { "VERSIONPROJECT", "1.2.0" },
+                { "HWVERSION",      "1.0.0" },
+                { "SWVERSION",      "1.2.0" },
+                { "BUILDDATE",      "12/16/2024" },
+                { "FIRMWAREREGION", "INDONESIA" },
+                { "SSIDAP",         "MicroBox-AP" },
+                { "PASSWORDAP",     "microbox123" },
+                { "SSIDSTA",        "HomeNetwork" },
+                { "PASSWORDSTA",    "secret-password" }
+            };
+
+            for (const auto &t : tokens) {
+                if (name == t.name) return t.value;
+            }
+            return nullptr;
+        }
+};
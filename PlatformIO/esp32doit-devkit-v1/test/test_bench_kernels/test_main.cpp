@@ -0,0 +1,116 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @brief Fixed-point sensor kernels against the float formulas, every 12-bit ADC code.
+ *  @author basyair7
+ *  @date 2024
+ *
+ *  Run with `pio test -e native -f test_bench_kernels -v` to see the table.
+ *  Host timings only compare the two paths; on the ESP32 the float path
+ *  also pays for software double math in pow().
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <unity.h>
+
+// Device calibration: 12-bit ADC, 3.25 V reference (see config.h)
+#define ESP32
+#include "MicroBox/SensorKernels.hpp"
+
+#define BENCH_ROUNDS 2000   ///< Passes over all ADC codes per timing
+
+static_assert(ADC_FULL_SCALE == 4095, "kernels must be checked at 12-bit resolution");
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// The float formulas the kernels replaced (PHSensor.hpp, WaterTurbidity.hpp)
+static float floatVolt(uint16_t adc) {
+    return adc * (VOLTAGE_REF / ADC_RESOLUTION);
+}
+
+static float floatPH(uint16_t adc) {
+    float steps = (PH4 - PH7) / 3;
+    return 7.0 + ((PH7 - floatVolt(adc)) / steps);
+}
+
+static float floatNTULinear(uint16_t adc) {
+    float ntu = NTU_CLEAN_WATER + ((float)(adc - ADC_CLEAN_WATER) * (NTU_DIRTY_WATER - NTU_CLEAN_WATER) / (ADC_DIRTY_WATER - ADC_CLEAN_WATER));
+    return (ntu < NTU_CLEAN_WATER) ? NTU_CLEAN_WATER : (ntu > NTU_DIRTY_WATER) ? NTU_DIRTY_WATER : ntu;
+}
+
+static float floatNTUPolynomial(uint16_t adc) {
+    float v = (adc / ADC_RESOLUTION) * VOLTAGE_REF;
+    return NTU_POLY_A * pow(v, 2) + NTU_POLY_B * v - NTU_POLY_C;
+}
+
+/**
+ * @brief Largest difference between a kernel and its float formula over every ADC code.
+ * @return Error in milli-units.
+ */
+template <typename Kernel, typename Reference>
+static double worstError(Kernel kernel, Reference reference) {
+    double worst = 0;
+    for (uint32_t adc = 0; adc <= ADC_FULL_SCALE; adc++) {
+        double err = fabs(kernel((uint16_t)adc) - 1000.0 * reference((uint16_t)adc));
+        if (err > worst) worst = err;
+    }
+    return worst;
+}
+
+/**
+ * @brief Time one conversion over every ADC code, BENCH_ROUNDS times.
+ * @return Nanoseconds per conversion.
+ */
+template <typename Convert>
+static double timePerCode(Convert convert) {
+    volatile float sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (volatile uint32_t adc = 0; adc <= ADC_FULL_SCALE; adc++) sink = convert((uint16_t)adc);
+    }
+    auto end = std::chrono::steady_clock::now();
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(end - start).count() / BENCH_ROUNDS / (ADC_FULL_SCALE + 1);
+}
+
+void test_kernels_match_float(void) {
+    double mv = worstError([](uint16_t adc) { return AdcToMillivolt::apply(adc); }, floatVolt);
+    double ph = worstError([](uint16_t adc) { return AdcToMilliPH::apply(adc); }, floatPH);
+    double linear = worstError([](uint16_t adc) {
+        return clampKernel(AdcToMilliNTULinear::apply(adc), NTU_CLEAN_WATER * 1000, NTU_DIRTY_WATER * 1000);
+    }, floatNTULinear);
+    double poly = worstError([](uint16_t adc) { return AdcToMilliNTUPolynomial::apply(adc); }, floatNTUPolynomial);
+
+    printf("worst error over %u codes: %.3f mV, %.3f milli-pH, %.3f milli-NTU linear, %.3f milli-NTU polynomial\n",
+        ADC_FULL_SCALE + 1, mv, ph, linear, poly);
+
+    // Within one milli-unit of the float result, plus float's own rounding
+    TEST_ASSERT_LESS_OR_EQUAL(1.0, mv);
+    TEST_ASSERT_LESS_OR_EQUAL(1.0, ph);
+    TEST_ASSERT_LESS_OR_EQUAL(3.0, linear);
+    TEST_ASSERT_LESS_OR_EQUAL(2.0, poly);
+}
+
+void test_bench_kernels(void) {
+    printf("%-22s %10s %10s\n", "conversion", "float", "fixed");
+    printf("%-22s %7.2f ns %7.2f ns\n", "millivolt",
+        timePerCode(floatVolt), timePerCode([](uint16_t adc) { return (float)AdcToMillivolt::apply(adc); }));
+    printf("%-22s %7.2f ns %7.2f ns\n", "pH",
+        timePerCode(floatPH), timePerCode([](uint16_t adc) { return (float)AdcToMilliPH::apply(adc); }));
+    printf("%-22s %7.2f ns %7.2f ns\n", "NTU linear",
+        timePerCode(floatNTULinear), timePerCode([](uint16_t adc) {
+            return (float)clampKernel(AdcToMilliNTULinear::apply(adc), NTU_CLEAN_WATER * 1000, NTU_DIRTY_WATER * 1000);
+        }));
+    printf("%-22s %7.2f ns %7.2f ns\n", "NTU polynomial",
+        timePerCode(floatNTUPolynomial), timePerCode([](uint16_t adc) { return (float)AdcToMilliNTUPolynomial::apply(adc); }));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_kernels_match_float);
+    RUN_TEST(test_bench_kernels);
+    return UNITY_END();
+}
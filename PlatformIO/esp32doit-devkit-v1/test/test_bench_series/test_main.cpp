@@ -0,0 +1,210 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @brief SeriesStore error paths, write amplification, append rate and index rebuild on the host.
+ *  @author basyair7
+ *  @date 2024
+ *
+ *  Run with `pio test -e native -f test_bench_series -v` to see the table.
+ *  The files live in a temp directory through the LittleFS shim, so the
+ *  rates are host rates; bytes written and the segment layout are the same
+ *  on the board.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <filesystem>
+#include <unity.h>
+#include <esp_system.h>
+#include "MicroBox/RetainedLog.h"
+#include "MicroBox/SeriesStore.h"
+
+#define BENCH_RECORDS   20000UL     ///< Records appended by the benchmark, past the first compaction
+
+static uint32_t sampleTime;
+
+void setUp(void) {
+    LittleFS.clear();
+    // Power-on: the retained ring starts empty for every test
+    mockResetReason = ESP_RST_POWERON;
+    RetainedLog::begin(0);
+    sampleTime = 1767225600UL;
+}
+
+void tearDown(void) {}
+
+/**
+ * @brief Close `count` record periods, running the writer task whenever add() wakes it.
+ * The period still open at the end stays in RAM.
+ */
+static void addRecords(SeriesStoreClass &store, size_t count) {
+    SensorSample sample = {};
+    sample.ph = 7.1f;
+    sample.ntu = 12.3f;
+    sample.capacity = 76.5f;
+
+    for (size_t i = 0; i <= count; i++) {
+        store.add(sample, sampleTime);
+        if (MockTask::notified > 0) MockTask::run();
+        if (i < count) sampleTime += SERIES_RECORD_PERIOD_S;
+    }
+}
+
+/**
+ * @brief Check every segment file has a header and whole records.
+ * @return Records in the files, or -1 if one is broken.
+ */
+static long storedRecords() {
+    long total = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(MockFS::host(SERIES_DIR))) {
+        char magic[4] = {};
+        FILE *file = fopen(entry.path().c_str(), "rb");
+        size_t got = file ? fread(magic, 1, sizeof(magic), file) : 0;
+        if (file) fclose(file);
+
+        size_t size = entry.file_size();
+        if (got != sizeof(magic) || memcmp(magic, "MBTS", 4) != 0 || size < 8 || (size - 8) % sizeof(SeriesRecord) != 0) {
+            printf("broken segment %s (%zu bytes)\n", entry.path().filename().c_str(), size);
+            return -1;
+        }
+        total += (size - 8) / sizeof(SeriesRecord);
+    }
+    return total;
+}
+
+void test_failed_open_indexes_nothing(void) {
+    SeriesStoreClass store;
+    TEST_ASSERT_TRUE(store.begin());
+
+    LittleFS.failOpens = 1;
+    addRecords(store, SERIES_BATCH_RECORDS);
+    TEST_ASSERT_EQUAL_UINT32(SERIES_BATCH_RECORDS, store.dropped());
+    TEST_ASSERT_EQUAL(0, storedRecords());
+
+    // The next batch starts the segment properly
+    addRecords(store, SERIES_BATCH_RECORDS);
+    TEST_ASSERT_EQUAL_UINT32(SERIES_BATCH_RECORDS, store.records());
+    TEST_ASSERT_EQUAL(SERIES_BATCH_RECORDS, storedRecords());
+    TEST_ASSERT_EQUAL(SERIES_BATCH_RECORDS, store.replay(0, [](const SeriesRecord &) {}));
+}
+
+void test_failed_header_removes_file(void) {
+    SeriesStoreClass store;
+    TEST_ASSERT_TRUE(store.begin());
+
+    LittleFS.failWrites = 1;
+    addRecords(store, SERIES_BATCH_RECORDS);
+    TEST_ASSERT_EQUAL_UINT32(SERIES_BATCH_RECORDS, store.dropped());
+    TEST_ASSERT_EQUAL(0, storedRecords());
+
+    addRecords(store, SERIES_BATCH_RECORDS);
+    TEST_ASSERT_EQUAL_UINT32(SERIES_BATCH_RECORDS, store.records());
+    TEST_ASSERT_EQUAL(SERIES_BATCH_RECORDS, storedRecords());
+}
+
+void test_partial_append_drops_only_the_rest(void) {
+    SeriesStoreClass store;
+    TEST_ASSERT_TRUE(store.begin());
+
+    // Half a batch first, so a later batch straddles the end of the segment
+    addRecords(store, SERIES_BATCH_RECORDS / 2);
+    MockTask::run();
+    addRecords(store, SERIES_SEGMENT_RECORDS - SERIES_BATCH_RECORDS);
+
+    // The first half lands in the old segment, the next segment cannot be opened
+    LittleFS.passOpens = 1;
+    LittleFS.failOpens = 1;
+    addRecords(store, SERIES_BATCH_RECORDS);
+    TEST_ASSERT_EQUAL_UINT32(SERIES_SEGMENT_RECORDS, store.records());
+    TEST_ASSERT_EQUAL_UINT32(SERIES_BATCH_RECORDS / 2, store.dropped());
+    TEST_ASSERT_EQUAL(SERIES_SEGMENT_RECORDS, storedRecords());
+}
+
+void test_failed_compaction_keeps_raw_segment(void) {
+    const size_t full = SERIES_SEGMENT_RECORDS * SERIES_RAW_SEGMENTS;
+    const size_t compacted = (SERIES_SEGMENT_RECORDS + SERIES_COMPACT_FACTOR - 1) / SERIES_COMPACT_FACTOR;
+    SeriesStoreClass store;
+    TEST_ASSERT_TRUE(store.begin());
+    addRecords(store, full);
+
+    // New raw segment and the first compacted batch succeed, the second batch fails
+    LittleFS.passOpens = 2;
+    LittleFS.failOpens = 1;
+    addRecords(store, SERIES_BATCH_RECORDS);
+    TEST_ASSERT_EQUAL_UINT32(0, store.dropped());
+    TEST_ASSERT_EQUAL(full + SERIES_BATCH_RECORDS + SERIES_BATCH_RECORDS, storedRecords());
+    // The compacted averages stand in for the raw records behind them
+    size_t behind = SERIES_BATCH_RECORDS * SERIES_COMPACT_FACTOR;
+    TEST_ASSERT_EQUAL(full + SERIES_BATCH_RECORDS - behind + SERIES_BATCH_RECORDS, store.replay(0, [](const SeriesRecord &) {}));
+
+    // The next flush finishes the segment without compacting a record twice
+    addRecords(store, SERIES_BATCH_RECORDS);
+    TEST_ASSERT_EQUAL(full - SERIES_SEGMENT_RECORDS + SERIES_BATCH_RECORDS * 2 + compacted, storedRecords());
+    TEST_ASSERT_EQUAL(full - SERIES_SEGMENT_RECORDS + SERIES_BATCH_RECORDS * 2 + compacted, store.replay(0, [](const SeriesRecord &) {}));
+}
+
+void test_rebuilt_index_replays_everything(void) {
+    const size_t count = SERIES_SEGMENT_RECORDS * 2 + SERIES_BATCH_RECORDS;
+    {
+        SeriesStoreClass store;
+        TEST_ASSERT_TRUE(store.begin());
+        addRecords(store, count);
+        TEST_ASSERT_EQUAL_UINT32(count, store.records());
+    }
+
+    SeriesStoreClass restarted;
+    TEST_ASSERT_TRUE(restarted.begin());
+    uint32_t last = 0;
+    bool ordered = true;
+    size_t replayed = restarted.replay(0, [&](const SeriesRecord &record) {
+        ordered = ordered && record.time > last;
+        last = record.time;
+    });
+    // The retained ring holds nothing newer than the files
+    TEST_ASSERT_EQUAL_UINT32(0, restarted.restored());
+    TEST_ASSERT_EQUAL(count, replayed);
+    TEST_ASSERT_TRUE(ordered);
+}
+
+void test_bench_series(void) {
+    SeriesStoreClass store;
+    TEST_ASSERT_TRUE(store.begin());
+
+    auto start = std::chrono::steady_clock::now();
+    addRecords(store, BENCH_RECORDS);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_EQUAL_UINT32(BENCH_RECORDS, store.records());
+    TEST_ASSERT_TRUE(storedRecords() > 0);
+
+    SeriesStoreClass restarted;
+    TEST_ASSERT_TRUE(restarted.begin());
+    size_t files = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(MockFS::host(SERIES_DIR))) {
+        (void)entry;
+        files++;
+    }
+
+    printf("%-28s %12lu\n", "records appended", BENCH_RECORDS);
+    printf("%-28s %12u B\n", "bytes written", store.bytesWritten());
+    printf("%-28s %12.3f\n", "write amplification", store.writeAmplification());
+    printf("%-28s %12.0f rec/s\n", "append rate", BENCH_RECORDS / seconds);
+    printf("%-28s %12u us\n", "worst batch write", store.worstFlushMicros());
+    printf("%-28s %12zu files\n", "segments on disk", files);
+    printf("%-28s %12u us\n", "index rebuild", restarted.rebuildMicros());
+
+    // Header per segment plus one compacted record per SERIES_COMPACT_FACTOR raw ones
+    TEST_ASSERT_EQUAL_UINT32(store.bytesWritten(), LittleFS.bytesWritten);
+    TEST_ASSERT_TRUE(store.writeAmplification() < 1.0f + 1.0f / SERIES_COMPACT_FACTOR + 0.01f);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_failed_open_indexes_nothing);
+    RUN_TEST(test_failed_header_removes_file);
+    RUN_TEST(test_partial_append_drops_only_the_rest);
+    RUN_TEST(test_failed_compaction_keeps_raw_segment);
+    RUN_TEST(test_rebuilt_index_replays_everything);
+    RUN_TEST(test_bench_series);
+    return UNITY_END();
+}
@@ -0,0 +1,128 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @brief TelemetryFrame against the ArduinoJson message it replaces: encode time and bytes.
+ *  @author basyair7
+ *  @date 2024
+ *
+ *  Run with `pio test -e native -f test_bench_telemetry -v` to see the table.
+ *  Host timings only compare the two encoders, they are not ESP32 timings.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <unity.h>
+#include <ArduinoJson.h>
+#include "MockWebHandlers.h"
+
+#define BENCH_ROUNDS 200000 ///< Frames per encoder
+
+/**
+ * The "data_server" WebSocket message, built by the same WebHandlers
+ * helpers as on the device.
+ */
+class JsonTelemetry : public MockWebHandlers {
+    public:
+        size_t encode(char *out, size_t len) {
+            StaticJsonDocument<RESPONSE_JSON_CAPACITY> doc;
+            doc["event"] = "data_server";
+            this->__getHeapMemory__(doc, this->status);
+            this->__getDataServer__(doc, this->status);
+            return serializeJson(doc, out, len);
+        }
+};
+
+static JsonTelemetry telemetry;
+
+void setUp(void) {
+    telemetry = JsonTelemetry();
+}
+
+void tearDown(void) {}
+
+static uint16_t get16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static uint32_t get32(const uint8_t *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+static void encode(uint8_t *frame, const SensorSample &sample) {
+    TEST_ASSERT_EQUAL(TELEMETRY_FRAME_SIZE, TelemetryFrame::encode(frame, 0, sample, 1792240496, 301.5f, 180.25f));
+}
+
+void test_frame_fields(void) {
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+    encode(frame, telemetry.status.sample);
+
+    TEST_ASSERT_EQUAL_MEMORY("MB", frame, 2);
+    TEST_ASSERT_EQUAL_UINT32(42, get32(frame + 4));
+    TEST_ASSERT_EQUAL_UINT16(30150, get16(frame + 16));
+    TEST_ASSERT_EQUAL_UINT16(7120, get16(frame + 20));
+    TEST_ASSERT_EQUAL_INT32(1234, (int32_t)get32(frame + 22));
+    TEST_ASSERT_EQUAL_INT16(7650, (int16_t)get16(frame + 26));
+    TEST_ASSERT_EQUAL_UINT16(98, get16(frame + 28));
+}
+
+void test_frame_clamps_out_of_range(void) {
+    SensorSample sample = telemetry.status.sample;
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+
+    // Failed readings encode as 0
+    sample.ph = NAN;
+    sample.ntu = NAN;
+    encode(frame, sample);
+    TEST_ASSERT_EQUAL_UINT16(0, get16(frame + 20));
+    TEST_ASSERT_EQUAL_INT32(0, (int32_t)get32(frame + 22));
+
+    // Beyond the field range, including values no integer type can hold
+    sample.ph = 1e30f;
+    sample.ntu = -INFINITY;
+    sample.capacity = 1e9f;
+    sample.distance = -5.0f;
+    encode(frame, sample);
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, get16(frame + 20));
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, (int32_t)get32(frame + 22));
+    TEST_ASSERT_EQUAL_INT16(INT16_MAX, (int16_t)get16(frame + 26));
+    TEST_ASSERT_EQUAL_UINT16(0, get16(frame + 28));
+
+    sample.ntu = 3e9f;
+    encode(frame, sample);
+    TEST_ASSERT_EQUAL_INT32(INT32_MAX, (int32_t)get32(frame + 22));
+}
+
+void test_bench_encoders(void) {
+    char json[RESPONSE_POOL_SLOT_SIZE];
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+    size_t jsonLen = 0, frameLen = 0;
+    SensorSample sample = telemetry.status.sample;
+    volatile uint8_t sink = 0; // keeps the frame loop from being optimized away
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        telemetry.status.sample.sequence = i;
+        jsonLen = telemetry.encode(json, sizeof(json));
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        sample.sequence = i;
+        frameLen = TelemetryFrame::encode(frame, 0, sample, 1792240496 + i, 301.5f, 180.25f);
+        sink = sink + frame[4];
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double jsonNs = std::chrono::duration<double, std::nano>(mid - start).count() / BENCH_ROUNDS;
+    double frameNs = std::chrono::duration<double, std::nano>(end - mid).count() / BENCH_ROUNDS;
+    printf("%-16s %10s %8s\n", "encoder", "time", "bytes");
+    printf("%-16s %7.1f ns %8zu\n", "ArduinoJson", jsonNs, jsonLen);
+    printf("%-16s %7.1f ns %8zu\n", "TelemetryFrame", frameNs, frameLen);
+    printf("frame is %.1fx smaller and %.1fx faster to encode\n", (double)jsonLen / frameLen, jsonNs / frameNs);
+
+    TEST_ASSERT_EQUAL(TELEMETRY_FRAME_SIZE, frameLen);
+    TEST_ASSERT_TRUE(jsonLen > frameLen);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_frame_fields);
+    RUN_TEST(test_frame_clamps_out_of_range);
+    RUN_TEST(test_bench_encoders);
+    return UNITY_END();
+}
@@ -0,0 +1,109 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @brief Latency, body size and heap allocations per web endpoint on the host.
+ *  @author basyair7
+ *  @date 2024
+ *
+ *  Run with `pio test -e native -f test_bench_web -v` to see the table.
+ *  Host timings only rank the endpoints and show regressions, they are not
+ *  ESP32 timings; body sizes and allocation counts are the same on both.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unity.h>
+#include "AllocCounter.h"
+#include "MockWebExchange.h"
+#include "MockWebHandlers.h"
+
+#define BENCH_ROUNDS 20000  ///< Requests per endpoint
+
+static MockWebHandlers handlers;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static std::string readFile(const char *path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+/**
+ * @brief Run one request BENCH_ROUNDS times and print a row of the table.
+ * @param name Row label.
+ * @param ex Exchange reused for every round.
+ * @param request Calls the handler.
+ */
+template <typename Request>
+static void bench(const char *name, MockWebExchange &ex, Request request) {
+    request(ex); // warm up, and the body size of one response
+
+    AllocCount before = allocCount();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ROUNDS; i++) request(ex);
+    auto end = std::chrono::steady_clock::now();
+    AllocCount used = allocCount(before);
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / BENCH_ROUNDS;
+    printf("%-28s %9.0f ns %7zu B %7.2f allocs %8.1f B heap\n", name, ns, ex.length,
+        (double)used.calls / BENCH_ROUNDS, (double)used.bytes / BENCH_ROUNDS);
+    TEST_ASSERT_TRUE(ex.code != 0);
+}
+
+void test_bench_json_endpoints(void) {
+    printf("%-28s %12s %9s %14s %14s\n", "endpoint", "latency", "body", "allocations", "heap/request");
+
+    MockWebExchange data("/data-server");
+    bench("/data-server (json)", data, [](MockWebExchange &ex) { handlers.__dataServer__(ex); });
+
+    MockWebExchange frame("/data-server");
+    frame.addHeader("Accept", TELEMETRY_MIME);
+    bench("/data-server (telemetry)", frame, [](MockWebExchange &ex) { handlers.__dataServer__(ex); });
+
+    MockWebExchange rtc("/rtc-server");
+    bench("/rtc-server", rtc, [](MockWebExchange &ex) { handlers.__rtcServer__(ex); });
+
+    MockWebExchange missing("/wp-login.php", false);
+    missing.addArg("log", "admin").addArg("pwd", "admin").addArg("redirect_to", "/wp-admin/")
+        .addArg("testcookie", "1").addArg("extra", "scanner");
+    bench("404 (5 args)", missing, [](MockWebExchange &ex) { handlers.__notFound__(ex); });
+}
+
+void test_bench_template_pages(void) {
+    const char *pages[] = {
+        "data/WEB/html/recovery.html",
+        "data/WEB/html/config_rtc.html",
+        "data/WEB/html/save_config_rtc.html"
+    };
+
+    for (const char *path : pages) {
+        std::string page = readFile(path);
+        TEST_ASSERT_TRUE_MESSAGE(page.size() > 0, path);
+
+        MockWebExchange ex(path);
+        const std::string *text = &page;
+        bench(strrchr(path, '/') + 1, ex, [text](MockWebExchange &ex) {
+            size_t pos = 0;
+            handlers.__page__(ex, [text, pos](uint8_t *buf, size_t len) mutable {
+                size_t n = text->size() - pos < len ? text->size() - pos : len;
+                memcpy(buf, text->data() + pos, n);
+                pos += n;
+                return n;
+            });
+        });
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_json_endpoints);
+    RUN_TEST(test_bench_template_pages);
+    return UNITY_END();
+}
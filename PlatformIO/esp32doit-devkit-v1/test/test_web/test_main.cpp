@@ -0,0 +1,217 @@
+/**
+ *  @file test_main.cpp
+ *  @version 1.0.0
+ *  @brief Native tests of WebHandlers, ResponsePool and TemplateRenderer, `pio test -e native -f test_web`.
+ *  @author basyair7
+ *  @date 2024
+ */
+
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unity.h>
+#include <ArduinoJson.h>
+#include "AllocCounter.h"
+#include "MockPooledExchange.h"
+#include "MockWebExchange.h"
+#include "MockWebHandlers.h"
+
+static MockWebHandlers handlers;
+
+void setUp(void) {
+    handlers = MockWebHandlers();
+}
+
+void tearDown(void) {}
+
+// Page source over a string, like the LittleFS reader on the device
+static TemplateRenderer::Reader stringReader(const std::string &page) {
+    const std::string *text = &page;
+    size_t pos = 0;
+    return [text, pos](uint8_t *buf, size_t len) mutable {
+        size_t n = text->size() - pos < len ? text->size() - pos : len;
+        memcpy(buf, text->data() + pos, n);
+        pos += n;
+        return n;
+    };
+}
+
+static std::string render(const std::string &page, size_t chunkLen) {
+    MockWebExchange ex("/page");
+    ex.chunkLen = chunkLen;
+    handlers.__page__(ex, stringReader(page));
+    TEST_ASSERT_EQUAL(200, ex.code);
+    TEST_ASSERT_EQUAL_STRING(TEXTHTML, ex.mime);
+    return std::string(ex.body, ex.length);
+}
+
+static std::string readFile(const char *path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+void test_data_server_json(void) {
+    MockWebExchange ex("/data-server");
+    handlers.__dataServer__(ex);
+
+    TEST_ASSERT_EQUAL(200, ex.code);
+    TEST_ASSERT_EQUAL_STRING(APPJSON, ex.mime);
+    TEST_ASSERT_EQUAL(ex.declared, ex.length);
+
+    StaticJsonDocument<RESPONSE_JSON_CAPACITY> doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, ex.body, ex.length));
+    TEST_ASSERT_EQUAL(200, doc["status"].as<int>());
+    TEST_ASSERT_EQUAL_STRING("301.50", doc["heap_memory"]["total_heap"]);
+    TEST_ASSERT_EQUAL_STRING("180.25", doc["heap_memory"]["free_heap"]);
+    TEST_ASSERT_EQUAL_STRING("10/17/2026", doc["data_server"]["date"]);
+    TEST_ASSERT_EQUAL_STRING("12:34:56 PM", doc["data_server"]["time"]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 7.12f, doc["data_server"]["sensor"]["ph"].as<float>());
+    TEST_ASSERT_EQUAL_UINT32(42, doc["data_server"]["sensor"]["sequence"].as<uint32_t>());
+}
+
+void test_data_server_telemetry(void) {
+    MockWebExchange ex("/data-server");
+    ex.addHeader("Accept", "text/html, " TELEMETRY_MIME);
+    handlers.__dataServer__(ex);
+
+    TEST_ASSERT_EQUAL(200, ex.code);
+    TEST_ASSERT_EQUAL_STRING(TELEMETRY_MIME, ex.mime);
+    TEST_ASSERT_EQUAL(TELEMETRY_FRAME_SIZE, ex.length);
+    TEST_ASSERT_EQUAL_MEMORY("MB", ex.body, 2);
+    TEST_ASSERT_EQUAL_HEX8(TELEMETRY_TOPIC_HTTP, (uint8_t)ex.body[3]);
+}
+
+void test_rtc_server(void) {
+    MockWebExchange ex("/rtc-server");
+    handlers.__rtcServer__(ex);
+
+    StaticJsonDocument<256> doc;
+    TEST_ASSERT_EQUAL(200, ex.code);
+    TEST_ASSERT_FALSE(deserializeJson(doc, ex.body, ex.length));
+    TEST_ASSERT_EQUAL_STRING("2026-10-17T12:34:56", doc["datetime"]["iso8601"]);
+}
+
+void test_not_found_echoes_first_args(void) {
+    MockWebExchange ex("/missing", false);
+    ex.addArg("a", "1").addArg("b", "2").addArg("c", "3").addArg("d", "4").addArg("e", "5").addArg("f", "6");
+    handlers.__notFound__(ex);
+
+    StaticJsonDocument<RESPONSE_JSON_CAPACITY> doc;
+    TEST_ASSERT_EQUAL(404, ex.code);
+    TEST_ASSERT_EQUAL(ex.declared, ex.length);
+    TEST_ASSERT_FALSE(deserializeJson(doc, ex.body, ex.length));
+    TEST_ASSERT_EQUAL_STRING("/missing", doc["uri"]);
+    TEST_ASSERT_EQUAL_STRING("POST", doc["method"]);
+    TEST_ASSERT_EQUAL(6, doc["args_count"].as<int>());
+    TEST_ASSERT_EQUAL(NOT_FOUND_MAX_ARGS, doc["args"].size());
+    TEST_ASSERT_EQUAL_STRING("4", doc["args"]["d"]);
+}
+
+void test_pooled_json_without_heap(void) {
+    MockPooledExchange ex("/data-server");
+
+    AllocCount before = allocCount();
+    handlers.__dataServer__(ex);
+    AllocCount used = allocCount(before);
+
+    // Document on the stack, body serialized straight into a pool slot
+    TEST_ASSERT_EQUAL(0, used.calls);
+    TEST_ASSERT_NOT_NULL(ex.slot);
+    TEST_ASSERT_EQUAL(1, ResponsePool::inUse());
+
+    // The body is const here, so the document also holds copies of the strings
+    StaticJsonDocument<2 * RESPONSE_JSON_CAPACITY> doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, ex.body, ex.length));
+    TEST_ASSERT_EQUAL(200, doc["status"].as<int>());
+
+    ex.disconnect();
+    TEST_ASSERT_EQUAL(0, ResponsePool::inUse());
+}
+
+void test_pooled_telemetry_without_heap(void) {
+    MockPooledExchange ex("/data-server", TELEMETRY_MIME);
+
+    AllocCount before = allocCount();
+    handlers.__dataServer__(ex);
+    AllocCount used = allocCount(before);
+
+    TEST_ASSERT_EQUAL(0, used.calls);
+    TEST_ASSERT_NOT_NULL(ex.slot);
+    TEST_ASSERT_EQUAL(TELEMETRY_FRAME_SIZE, ex.length);
+    TEST_ASSERT_EQUAL_MEMORY("MB", ex.body, 2);
+}
+
+void test_pool_exhausted_falls_back_to_stream(void) {
+    // Connections that have not finished reading their response yet
+    MockPooledExchange busy[RESPONSE_POOL_SLOTS];
+    for (auto &ex : busy) handlers.__rtcServer__(ex);
+    TEST_ASSERT_EQUAL(RESPONSE_POOL_SLOTS, ResponsePool::inUse());
+
+    uint32_t exhausted = ResponsePool::exhausted();
+    MockPooledExchange ex("/rtc-server");
+    handlers.__rtcServer__(ex);
+    TEST_ASSERT_NULL(ex.slot);
+    TEST_ASSERT_TRUE(ex.body == ex.stream);
+    TEST_ASSERT_EQUAL(exhausted + 1, ResponsePool::exhausted());
+
+    StaticJsonDocument<512> doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, ex.body, ex.length));
+    TEST_ASSERT_EQUAL_STRING("2026-10-17T12:34:56", doc["datetime"]["iso8601"]);
+
+    for (auto &b : busy) b.disconnect();
+    TEST_ASSERT_EQUAL(0, ResponsePool::inUse());
+}
+
+void test_template_tokens(void) {
+    std::string page = "<p>%LOCALIP% v%VERSIONPROJECT% %UNKNOWN% 100%; %% %SSIDAP%</p>";
+    std::string expected = "<p>192.168.4.1 v1.2.0 %UNKNOWN% 100%; % MicroBox-AP</p>";
+
+    // Every chunk size puts the boundaries somewhere else inside the placeholders
+    for (size_t chunkLen = 1; chunkLen <= 16; chunkLen++) {
+        TEST_ASSERT_EQUAL_STRING(expected.c_str(), render(page, chunkLen).c_str());
+    }
+}
+
+void test_template_unterminated(void) {
+    TEST_ASSERT_EQUAL_STRING("50% done %LOCALIP", render("50% done %LOCALIP", 8).c_str());
+
+    // Too long for a placeholder name, sent as text
+    std::string run = "%" + std::string(TEMPLATE_TOKEN_LEN + 4, 'A') + "%";
+    TEST_ASSERT_EQUAL_STRING(run.c_str(), render(run, MOCK_CHUNK_LEN).c_str());
+}
+
+void test_template_pages(void) {
+    const char *pages[] = {
+        "data/WEB/html/recovery.html",
+        "data/WEB/html/config_rtc.html",
+        "data/WEB/html/save_config_rtc.html"
+    };
+
+    for (const char *path : pages) {
+        std::string page = readFile(path);
+        TEST_ASSERT_TRUE_MESSAGE(page.size() > 0, path);
+
+        std::string html = render(page, MOCK_CHUNK_LEN);
+        TEST_ASSERT_TRUE_MESSAGE(html.find("%LOCALIP%") == std::string::npos, path);
+        TEST_ASSERT_TRUE_MESSAGE(html.find("%VERSIONPROJECT%") == std::string::npos, path);
+        TEST_ASSERT_TRUE_MESSAGE(html.find("192.168.4.1") != std::string::npos, path);
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_data_server_json);
+    RUN_TEST(test_data_server_telemetry);
+    RUN_TEST(test_rtc_server);
+    RUN_TEST(test_not_found_echoes_first_args);
+    RUN_TEST(test_pooled_json_without_heap);
+    RUN_TEST(test_pooled_telemetry_without_heap);
+    RUN_TEST(test_pool_exhausted_falls_back_to_stream);
+    RUN_TEST(test_template_tokens);
+    RUN_TEST(test_template_unterminated);
+    RUN_TEST(test_template_pages);
+    return UNITY_END();
+}